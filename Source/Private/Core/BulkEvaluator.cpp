@@ -0,0 +1,355 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/BulkEvaluator.h"
+
+namespace NR
+{
+	namespace
+	{
+		constexpr int32_t TabulatedRow = -2; // Chosen value of the rows read from a gait table
+
+		int64_t FindInputOffset(const NRModelProfile& Profile, const std::string& Name)
+		{
+			for (const auto& block : Profile.Inputs)
+			{
+				if (block.Name == Name)
+				{
+					return block.Offset;
+				}
+			}
+			return -1;
+		}
+	} // namespace
+
+	BulkEvaluator::BulkEvaluator(Rules& Source, const NRModelProfile& Profile)
+		: Source(Source)
+	{
+		TCycleInput = FindInputOffset(Profile, "t_cycle");
+
+		const int numBindings = static_cast<int>(std::min(Source.CompiledRules.size(), Profile.Bindings.size()));
+		Bindings.resize(numBindings);
+
+		for (int b = 0; b < numBindings; ++b)
+		{
+			BindingState& state = Bindings[b];
+			state.Offset = Profile.Bindings[b].Offset;
+
+			for (auto& [name, value] : Source.Vars[b])
+			{
+				state.ColumnOfSlot[&value] = state.Names.size();
+				state.Names.push_back(name);
+				state.Scalars.push_back(&value);
+			}
+			state.Columns.resize(state.Names.size());
+
+			for (auto& compiled : Source.CompiledRules[b])
+			{
+				if (compiled.Logic.empty())
+				{
+					continue;
+				}
+
+				const double* tGaitSlot = Source.GetTGaitSlot(compiled, b);
+				for (const auto& input : Source.GetInputs(compiled, b, Profile))
+				{
+					const size_t column = state.ColumnOfSlot.at(input.Slot);
+					if (input.bClock)
+					{
+						BindingState::ClockRead read;
+						read.Column = column;
+						if (tGaitSlot)
+						{
+							read.TGait = compiled.TGait;
+							read.TGaitColumn = state.ColumnOfSlot.at(tGaitSlot);
+						}
+						state.ClockReads.push_back(read);
+						continue;
+					}
+					state.InputColumns.emplace_back(column, input.Offset);
+				}
+
+				auto addParser = [&](ExprHandle handle) {
+					if (state.ParserIndex.contains(handle))
+					{
+						return;
+					}
+
+					// Copy of the binding parser keeps fmod, clamp, pow and _pi
+					mu::Parser& parser = state.Parsers.emplace_back(Source.Parsers[b]);
+					parser.SetExpr(Source.GetSource(handle));
+					state.ParserIndex.emplace(handle, state.Parsers.size() - 1);
+				};
+
+				for (const auto& [_slot, handle] : compiled.Logic)
+				{
+					addParser(handle);
+				}
+				for (const auto& phase : compiled.Phases)
+				{
+					addParser(phase.Condition);
+					for (const auto handle : phase.Formulas)
+					{
+						addParser(handle);
+					}
+				}
+			}
+		}
+	}
+
+	void BulkEvaluator::Reserve(int64_t Rows)
+	{
+		if (Rows <= Capacity)
+		{
+			return;
+		}
+
+		Capacity = std::max<int64_t>(Rows, Capacity * 2);
+		Scratch.resize(Capacity);
+		ClockInput.resize(Capacity);
+
+		// Columns moved, bulk parsers have to point at the new arrays
+		for (auto& state : Bindings)
+		{
+			for (auto& column : state.Columns)
+			{
+				column.resize(Capacity);
+			}
+			for (auto& parser : state.Parsers)
+			{
+				for (size_t c = 0; c < state.Names.size(); ++c)
+				{
+					parser.DefineVar(state.Names[c], state.Columns[c].data());
+				}
+			}
+		}
+	}
+
+	void BulkEvaluator::EvalColumn(BindingState& State, ExprHandle Handle, double* Result, int64_t Rows)
+	{
+		try
+		{
+			State.Parsers[State.ParserIndex.at(Handle)].Eval(Result, static_cast<int>(Rows));
+		}
+		catch (mu::Parser::exception_type& e)
+		{
+			std::cout << "Error evaluating expression [" << Source.GetSource(Handle) << "]: " << e.GetMsg() << std::endl;
+			std::fill(Result, Result + Rows, 0.0);
+		}
+	}
+
+	void BulkEvaluator::Evaluate(const torch::Tensor& Inputs, float* Out, int64_t OutCount)
+	{
+		auto rows2D = Inputs.to(torch::kFloat).reshape({Inputs.dim() > 1 ? Inputs.size(0) : 1, -1}).contiguous();
+		const int64_t rows = rows2D.size(0);
+		const int64_t inCount = rows2D.size(1);
+		const float* input = rows2D.data_ptr<float>();
+		if (rows == 0)
+		{
+			return;
+		}
+
+		Reserve(rows);
+
+		// 1. Columns start from the scalar state (constants, phase variables), then inputs are gathered
+		for (auto& state : Bindings)
+		{
+			for (size_t c = 0; c < state.Columns.size(); ++c)
+			{
+				std::fill(state.Columns[c].begin(), state.Columns[c].begin() + rows, *state.Scalars[c]);
+			}
+			for (const auto& [column, offset] : state.InputColumns)
+			{
+				double* dst = state.Columns[column].data();
+				for (int64_t r = 0; r < rows; ++r)
+				{
+					dst[r] = input[r * inCount + offset];
+				}
+			}
+		}
+
+		// 2. Logic once to know T_gait on every row, t_cycle is still the previous value here
+		for (int b = 0; b < static_cast<int>(Bindings.size()); ++b)
+		{
+			auto& state = Bindings[b];
+			const bool bNeedsTGait = std::any_of(state.ClockReads.begin(), state.ClockReads.end(), [](const auto& read) {
+				return read.TGait != InvalidExpr;
+			});
+			if (!bNeedsTGait)
+			{
+				continue;
+			}
+
+			for (const auto& compiled : Source.CompiledRules[b])
+			{
+				for (const auto& [slot, handle] : compiled.Logic)
+				{
+					EvalColumn(state, handle, state.Columns[state.ColumnOfSlot.at(slot)].data(), rows);
+				}
+			}
+		}
+
+		// 3. Gait clock, sequential across rows and shared by every binding
+		if (TCycleInput >= 0)
+		{
+			for (int64_t r = 0; r < rows; ++r)
+			{
+				ClockInput[r] = input[r * inCount + TCycleInput];
+			}
+		}
+
+		double& deltaTime = Source.deltaTime;
+		for (int64_t r = 0; r < rows; ++r)
+		{
+			for (auto& state : Bindings)
+			{
+				for (const auto& read : state.ClockReads)
+				{
+					deltaTime += TCycleInput >= 0 ? ClockInput[r] : 0.0;
+					if (read.TGait == InvalidExpr)
+					{
+						continue;
+					}
+
+					const double T_gait = r == 0 ? Source.Eval(read.TGait) : state.Columns[read.TGaitColumn][r - 1];
+					if (T_gait > 0.0)
+					{
+						deltaTime = std::fmod(deltaTime, T_gait);
+					}
+					state.Columns[read.Column][r] = deltaTime;
+				}
+			}
+		}
+
+		// 4. Logic, conditions and formulas over the batch, phases picked with a mask
+		std::vector<int32_t> chosen(rows);
+		for (int b = 0; b < static_cast<int>(Bindings.size()); ++b)
+		{
+			auto& state = Bindings[b];
+			for (auto& compiled : Source.CompiledRules[b])
+			{
+				if (compiled.Logic.empty())
+				{
+					continue;
+				}
+
+				for (const auto& [slot, handle] : compiled.Logic)
+				{
+					EvalColumn(state, handle, state.Columns[state.ColumnOfSlot.at(slot)].data(), rows);
+				}
+
+				std::fill(chosen.begin(), chosen.end(), -1);
+				int64_t pending = rows;
+				if (Source.HasGaitTables())
+				{
+					// Built from the first row, the way the scalar path builds it from a frame
+					if (!compiled.Tabulated.Table && !compiled.Tabulated.bRejected)
+					{
+						for (size_t c = 0; c < state.Columns.size(); ++c)
+						{
+							*state.Scalars[c] = state.Columns[c][0];
+						}
+					}
+					if (const auto* tabulated = Source.GetGaitTable(compiled, b))
+					{
+						pending -= LookupGaitTable(state, *tabulated, rows, Out, OutCount, chosen);
+					}
+				}
+
+				for (size_t p = 0; p < compiled.Phases.size() && pending > 0; ++p)
+				{
+					EvalColumn(state, compiled.Phases[p].Condition, Scratch.data(), rows);
+					for (int64_t r = 0; r < rows; ++r)
+					{
+						if (chosen[r] == -1 && Scratch[r] != 0.0)
+						{
+							chosen[r] = static_cast<int32_t>(p);
+							--pending;
+						}
+					}
+				}
+
+				for (size_t p = 0; p < compiled.Phases.size(); ++p)
+				{
+					const auto phaseId = static_cast<int32_t>(p);
+					if (std::find(chosen.begin(), chosen.end(), phaseId) == chosen.end())
+					{
+						continue;
+					}
+
+					const auto& formulas = compiled.Phases[p].Formulas;
+					for (size_t f = 0; f < formulas.size(); ++f)
+					{
+						const int64_t column = state.Offset + static_cast<int64_t>(f);
+						if (column >= OutCount)
+						{
+							break;
+						}
+
+						EvalColumn(state, formulas[f], Scratch.data(), rows);
+						for (int64_t r = 0; r < rows; ++r)
+						{
+							if (chosen[r] == phaseId)
+							{
+								Out[r * OutCount + column] = static_cast<float>(Scratch[r]);
+							}
+						}
+					}
+				}
+			}
+
+			// 5. Scalar state continues from the last row
+			for (size_t c = 0; c < state.Columns.size(); ++c)
+			{
+				*state.Scalars[c] = state.Columns[c][rows - 1];
+			}
+		}
+	}
+
+	int64_t BulkEvaluator::LookupGaitTable(const BindingState& State, const Rules::CompiledRule::TableState& Tabulated, int64_t Rows,
+	                                       float* Out, int64_t OutCount, std::vector<int32_t>& Chosen)
+	{
+		const GaitTable& table = *Tabulated.Table;
+		const double* phase = State.Columns[State.ColumnOfSlot.at(Tabulated.Phase)].data();
+		const double* velocity = State.Columns[State.ColumnOfSlot.at(Tabulated.Velocity)].data();
+
+		std::vector<std::pair<const double*, double>> guards;
+		for (const auto& [slot, value] : Tabulated.Guards)
+		{
+			guards.emplace_back(State.Columns[State.ColumnOfSlot.at(slot)].data(), value);
+		}
+
+		std::vector<float> cell(table.GetOutputs());
+		int64_t written = 0;
+		for (int64_t r = 0; r < Rows; ++r)
+		{
+			const bool bGuarded = std::all_of(guards.begin(), guards.end(), [r](const auto& guard) {
+				return guard.first[r] == guard.second;
+			});
+			if (!bGuarded || !table.Lookup(phase[r], velocity[r], cell.data()))
+			{
+				continue;
+			}
+
+			for (int32_t f = 0; f < table.GetOutputs() && State.Offset + f < OutCount; ++f)
+			{
+				Out[r * OutCount + State.Offset + f] = cell[f];
+			}
+			Chosen[r] = TabulatedRow;
+			++written;
+		}
+		return written;
+	}
+} // namespace NR
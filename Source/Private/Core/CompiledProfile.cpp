@@ -0,0 +1,66 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/CompiledProfile.h"
+#include <iostream>
+
+namespace NR
+{
+	namespace
+	{
+		bool SameBlocks(const std::vector<NRDataBlock>& A, const std::vector<NRDataBlock>& B)
+		{
+			if (A.size() != B.size())
+			{
+				return false;
+			}
+			for (size_t i = 0; i < A.size(); ++i)
+			{
+				if (A[i].Name != B[i].Name || A[i].Offset != B[i].Offset || A[i].FloatCount != B[i].FloatCount)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+	} // namespace
+
+	NRCompiledProfile NRCompiledProfile::Compile(NRModelProfile Profile, const Rules& Base)
+	{
+		NRCompiledProfile compiled{std::move(Profile), Base};
+		compiled.Layout = Kinematics::BuildLayout(compiled.Profile.Skeleton);
+		compiled.Weights = NRWeightPlan::Compile(compiled.Profile.TrainingWeights, compiled.Layout);
+
+		const auto& bindings = compiled.Profile.Bindings;
+		for (size_t i = 0; i < bindings.size(); ++i)
+		{
+			for (const auto& rule : bindings[i].Rules)
+			{
+				if (rule.Name.empty())
+				{
+					std::cerr << "[CompiledProfile] Rule not found: " << bindings[i].RuleName << std::endl;
+					continue;
+				}
+				compiled.Evaluator.Setup(rule, static_cast<int>(i), compiled.Profile);
+			}
+		}
+		return compiled;
+	}
+
+	bool NRCompiledProfile::SameLayout(const NRModelProfile& A, const NRModelProfile& B)
+	{
+		return SameBlocks(A.Inputs, B.Inputs) && SameBlocks(A.Outputs, B.Outputs);
+	}
+} // namespace NR
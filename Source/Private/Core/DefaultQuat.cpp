@@ -0,0 +1,68 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/DefaultQuat.h"
+
+namespace NR
+{
+	Quat DefaultQuat::ToQuat(float pitch, float yaw, float roll) const
+	{
+		return ToQuatBatch(torch::tensor({pitch, yaw, roll}, torch::kFloat32));
+	}
+
+	Vec3 DefaultQuat::ToEuler(const Quat& q) const
+	{
+		return ToEulerBatch(q);
+	}
+
+	Quat DefaultQuat::ToQuatBatch(const Vec3& Euler) const
+	{
+		auto half = Euler * 0.5f;
+		auto cp = torch::cos(half.select(-1, 0));
+		auto sp = torch::sin(half.select(-1, 0));
+		auto cy = torch::cos(half.select(-1, 1));
+		auto sy = torch::sin(half.select(-1, 1));
+		auto cr = torch::cos(half.select(-1, 2));
+		auto sr = torch::sin(half.select(-1, 2));
+
+		auto x = cy * cp * sr - sy * sp * cr;
+		auto y = cy * sp * cr + sy * cp * sr;
+		auto z = sy * cp * cr - cy * sp * sr;
+		auto w = cy * cp * cr + sy * sp * sr;
+
+		return torch::stack({x, y, z, w}, -1);
+	}
+
+	Vec3 DefaultQuat::ToEulerBatch(const Quat& Q) const
+	{
+		auto q = Q / (Q.norm(2, -1, true) + 1e-8f);
+
+		auto x = q.select(-1, 0);
+		auto y = q.select(-1, 1);
+		auto z = q.select(-1, 2);
+		auto w = q.select(-1, 3);
+
+		// Roll (X)
+		auto roll = torch::atan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y));
+
+		// Pitch (Y), clamped so asin stays differentiable at the poles
+		auto pitch = torch::asin(torch::clamp(2.0f * (w * y - z * x), -0.999999f, 0.999999f));
+
+		// Yaw (Z)
+		auto yaw = torch::atan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z));
+
+		return torch::stack({pitch, yaw, roll}, -1);
+	}
+} // namespace NR
@@ -0,0 +1,126 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/Diagnostics.h"
+
+namespace NR
+{
+	Diagnostics::~Diagnostics()
+	{
+		Disable();
+	}
+
+	void Diagnostics::Enable(int32_t Interval)
+	{
+		SampleInterval = std::max(Interval, 1);
+
+		std::lock_guard<std::mutex> lock(Mutex);
+		if (!Worker.joinable())
+		{
+			bStopping = false;
+			Worker = std::thread(&Diagnostics::Run, this);
+		}
+		bEnabled = true;
+	}
+
+	void Diagnostics::Disable()
+	{
+		bEnabled = false;
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			bStopping = true;
+		}
+		Signal.notify_one();
+
+		if (Worker.joinable())
+		{
+			Worker.join();
+		}
+	}
+
+	bool Diagnostics::ShouldSample()
+	{
+		if (!IsEnabled())
+		{
+			return false;
+		}
+
+		return ++FrameCounter % static_cast<uint64_t>(SampleInterval.load(std::memory_order_relaxed)) == 0;
+	}
+
+	void Diagnostics::Post(const std::string& Title, const ValueList& Values)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		Entry entry;
+		entry.Title = Title;
+		entry.Frame = FrameCounter;
+		entry.Values.reserve(Values.size());
+		for (const auto& [name, value] : Values)
+		{
+			entry.Values.emplace_back(name, value.defined() ? value.detach().clone() : torch::Tensor());
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			if (Pending.size() >= MaxPending)
+			{
+				return;
+			}
+			Pending.push_back(std::move(entry));
+		}
+		Signal.notify_one();
+	}
+
+	void Diagnostics::Run()
+	{
+		while (true)
+		{
+			Entry entry;
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				Signal.wait(lock, [this] { return bStopping || !Pending.empty(); });
+				if (Pending.empty())
+				{
+					return;
+				}
+				entry = std::move(Pending.front());
+				Pending.pop_front();
+			}
+
+			std::cout << "--- " << entry.Title << " | Frame: " << entry.Frame << " ---" << std::endl;
+			for (const auto& [name, value] : entry.Values)
+			{
+				std::cout << "  " << name << ": ";
+				if (!value.defined())
+				{
+					std::cout << "-";
+				}
+				else if (value.numel() == 1)
+				{
+					std::cout << value.item<float>();
+				}
+				else
+				{
+					std::cout << value;
+				}
+				std::cout << std::endl;
+			}
+		}
+	}
+} // namespace NR
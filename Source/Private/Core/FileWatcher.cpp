@@ -0,0 +1,175 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/FileWatcher.h"
+#include <iostream>
+#include <map>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace NR
+{
+	namespace
+	{
+		// How often the watcher thread checks for Stop
+		constexpr int WakeMs = 100;
+	} // namespace
+
+	FileWatcher::FileWatcher(std::vector<std::string> InPaths, Callback InOnChange, std::chrono::milliseconds InDebounce)
+		: Paths(std::move(InPaths))
+		, OnChange(std::move(InOnChange))
+		, Debounce(InDebounce)
+	{
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+	}
+
+	bool FileWatcher::Start()
+	{
+		if (bRunning || Paths.empty())
+		{
+			return false;
+		}
+
+#ifdef __linux__
+		NotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (NotifyFd < 0)
+		{
+			std::cerr << "[FileWatcher] inotify unavailable, polling instead" << std::endl;
+		}
+#endif
+
+		bRunning = true;
+		Worker = NotifyFd >= 0 ? std::thread(&FileWatcher::RunNotify, this) : std::thread(&FileWatcher::RunPolling, this);
+		return true;
+	}
+
+	void FileWatcher::Stop()
+	{
+		bRunning = false;
+		if (Worker.joinable())
+		{
+			Worker.join();
+		}
+
+#ifdef __linux__
+		if (NotifyFd >= 0)
+		{
+			close(NotifyFd);
+			NotifyFd = -1;
+		}
+#endif
+	}
+
+	std::vector<std::filesystem::file_time_type> FileWatcher::Snapshot() const
+	{
+		std::vector<std::filesystem::file_time_type> times;
+		times.reserve(Paths.size());
+		for (const auto& path : Paths)
+		{
+			std::error_code error;
+			times.push_back(std::filesystem::last_write_time(path, error)); // Missing files read as the minimum time
+		}
+		return times;
+	}
+
+	void FileWatcher::RunNotify()
+	{
+#ifdef __linux__
+		// Directories are watched rather than the files, which editors often replace
+		std::map<int, std::set<std::string>> watched;
+		for (const auto& path : Paths)
+		{
+			const std::filesystem::path file(path);
+			const auto directory = file.has_parent_path() ? file.parent_path() : std::filesystem::path(".");
+			const int wd = inotify_add_watch(NotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+			if (wd < 0)
+			{
+				std::cerr << "[FileWatcher] Cannot watch " << directory << std::endl;
+				continue;
+			}
+			watched[wd].insert(file.filename().string());
+		}
+
+		alignas(inotify_event) char buffer[4096];
+		bool bDirty = false;
+		auto lastChange = std::chrono::steady_clock::now();
+
+		while (bRunning)
+		{
+			pollfd descriptor{NotifyFd, POLLIN, 0};
+			if (poll(&descriptor, 1, WakeMs) > 0 && (descriptor.revents & POLLIN))
+			{
+				ssize_t length;
+				while ((length = read(NotifyFd, buffer, sizeof(buffer))) > 0)
+				{
+					for (char* cursor = buffer; cursor < buffer + length;)
+					{
+						const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+						cursor += sizeof(inotify_event) + event->len;
+
+						auto names = watched.find(event->wd);
+						if (event->len > 0 && names != watched.end() && names->second.count(event->name))
+						{
+							bDirty = true;
+							lastChange = std::chrono::steady_clock::now();
+						}
+					}
+				}
+			}
+
+			if (bDirty && std::chrono::steady_clock::now() - lastChange >= Debounce)
+			{
+				bDirty = false;
+				OnChange();
+			}
+		}
+#endif
+	}
+
+	void FileWatcher::RunPolling()
+	{
+		auto known = Snapshot();
+		bool bDirty = false;
+		auto lastChange = std::chrono::steady_clock::now();
+
+		while (bRunning)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(WakeMs));
+
+			auto current = Snapshot();
+			if (current != known)
+			{
+				known = std::move(current);
+				bDirty = true;
+				lastChange = std::chrono::steady_clock::now();
+			}
+
+			if (bDirty && std::chrono::steady_clock::now() - lastChange >= Debounce)
+			{
+				bDirty = false;
+				OnChange();
+			}
+		}
+	}
+} // namespace NR
@@ -0,0 +1,213 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Core.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace NR
+{
+	/**
+	 * @brief Per-bone steps shared by the fixed and the generic pose kernels.
+	 *
+	 * Poses are flat rows where bone i starts at Offsets[i] with its local position
+	 * (3) followed by its local quaternion [x, y, z, w] (4). Global rotations are
+	 * row-major 3x3 matrices, the conventions of Kinematics::Forward.
+	 */
+	template<FloatingPoint T>
+	struct PoseBoneOps
+	{
+		static constexpr T Epsilon = static_cast<T>(1e-8);
+
+		static void QuatToMat(const T* Q, T* M)
+		{
+			const T s = std::sqrt(Q[0] * Q[0] + Q[1] * Q[1] + Q[2] * Q[2] + Q[3] * Q[3]) + Epsilon;
+			const T x = Q[0] / s, y = Q[1] / s, z = Q[2] / s, w = Q[3] / s;
+
+			M[0] = 1 - 2 * (y * y + z * z);
+			M[1] = 2 * (x * y - w * z);
+			M[2] = 2 * (x * z + w * y);
+			M[3] = 2 * (x * y + w * z);
+			M[4] = 1 - 2 * (x * x + z * z);
+			M[5] = 2 * (y * z - w * x);
+			M[6] = 2 * (x * z - w * y);
+			M[7] = 2 * (y * z + w * x);
+			M[8] = 1 - 2 * (x * x + y * y);
+		}
+
+		// pChild = pParent + mParent * pLocal, mChild = mParent * mLocal
+		static void Compose(const T* Bone, int64_t Parent, T* GlobalPos, T* GlobalRot, int64_t Index)
+		{
+			T* pos = GlobalPos + Index * 3;
+			T* rot = GlobalRot + Index * 9;
+			if (Parent < 0)
+			{
+				QuatToMat(Bone + 3, rot);
+				pos[0] = Bone[0];
+				pos[1] = Bone[1];
+				pos[2] = Bone[2];
+				return;
+			}
+
+			T local[9];
+			QuatToMat(Bone + 3, local);
+			const T* pp = GlobalPos + Parent * 3;
+			const T* rp = GlobalRot + Parent * 9;
+			for (int a = 0; a < 3; ++a)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					rot[a * 3 + c] = rp[a * 3 + 0] * local[0 * 3 + c] + rp[a * 3 + 1] * local[1 * 3 + c] + rp[a * 3 + 2] * local[2 * 3 + c];
+				}
+				pos[a] = pp[a] + rp[a * 3 + 0] * Bone[0] + rp[a * 3 + 1] * Bone[1] + rp[a * 3 + 2] * Bone[2];
+			}
+		}
+
+		// Unit quaternion, and the bone vector scaled to its rest length (roots keep their position)
+		static void Constrain(T* Bone, int64_t Parent, T RestLength)
+		{
+			const T n = std::sqrt(Bone[3] * Bone[3] + Bone[4] * Bone[4] + Bone[5] * Bone[5] + Bone[6] * Bone[6]);
+			if (n > Epsilon)
+			{
+				Bone[3] /= n;
+				Bone[4] /= n;
+				Bone[5] /= n;
+				Bone[6] /= n;
+			}
+			else
+			{
+				Bone[3] = Bone[4] = Bone[5] = 0;
+				Bone[6] = 1;
+			}
+
+			const T length = std::sqrt(Bone[0] * Bone[0] + Bone[1] * Bone[1] + Bone[2] * Bone[2]);
+			if (Parent >= 0 && RestLength > Epsilon && length > Epsilon)
+			{
+				const T k = RestLength / length;
+				Bone[0] *= k;
+				Bone[1] *= k;
+				Bone[2] *= k;
+			}
+		}
+	};
+
+	/**
+	 * @brief A root with chains of fixed lengths hanging off it, known at compile time.
+	 *
+	 * Bone 0 is the root, followed by the bones of each chain in order, which is the
+	 * order Kinematics::BuildLayout produces for such a skeleton.
+	 */
+	template<int32_t... ChainLengths>
+	struct ChainTopology
+	{
+		static constexpr int64_t NumChains = sizeof...(ChainLengths);
+		static constexpr int64_t NumBones = 1 + (int64_t(0) + ... + ChainLengths);
+
+		static constexpr std::array<int64_t, NumBones> Parents = [] {
+			std::array<int64_t, NumBones> parents{};
+			parents[0] = -1;
+			int64_t bone = 1;
+			for (const int32_t length : {ChainLengths...})
+			{
+				for (int32_t k = 0; k < length; ++k, ++bone)
+				{
+					parents[bone] = k == 0 ? 0 : bone - 1;
+				}
+			}
+			return parents;
+		}();
+	};
+
+	/**
+	 * @brief FK and bone constraints unrolled over a compile-time topology.
+	 *
+	 * Parent indices are constants, so the bone loop is unrolled and every step is
+	 * inlined with its parent resolved at compile time.
+	 */
+	template<typename Topology, FloatingPoint T>
+	class FixedPoseKernel
+	{
+	public:
+		static constexpr int64_t NumBones = Topology::NumBones;
+
+		static void Forward(const T* Pose, int64_t Batch, int64_t Stride, const int64_t* Offsets, T* GlobalPos, T* GlobalRot)
+		{
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				ForwardRow(Pose + b * Stride, Offsets, GlobalPos + b * NumBones * 3, GlobalRot + b * NumBones * 9,
+				           std::make_integer_sequence<int64_t, NumBones>{});
+			}
+		}
+
+		static void Constrain(T* Pose, int64_t Batch, int64_t Stride, const int64_t* Offsets, const T* RestLength)
+		{
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				ConstrainRow(Pose + b * Stride, Offsets, RestLength, std::make_integer_sequence<int64_t, NumBones>{});
+			}
+		}
+
+	private:
+		template<int64_t... Bones>
+		static void ForwardRow(const T* Row, const int64_t* Offsets, T* GlobalPos, T* GlobalRot, std::integer_sequence<int64_t, Bones...>)
+		{
+			(PoseBoneOps<T>::Compose(Row + Offsets[Bones], Topology::Parents[Bones], GlobalPos, GlobalRot, Bones), ...);
+		}
+
+		template<int64_t... Bones>
+		static void ConstrainRow(T* Row, const int64_t* Offsets, const T* RestLength, std::integer_sequence<int64_t, Bones...>)
+		{
+			(PoseBoneOps<T>::Constrain(Row + Offsets[Bones], Topology::Parents[Bones], RestLength[Bones]), ...);
+		}
+	};
+
+	/**
+	 * @brief Same operations over a runtime parent array, for any other topology.
+	 */
+	template<FloatingPoint T>
+	class GenericPoseKernel
+	{
+	public:
+		static void Forward(const int64_t* Parents, int64_t NumBones, const T* Pose, int64_t Batch, int64_t Stride,
+		                    const int64_t* Offsets, T* GlobalPos, T* GlobalRot)
+		{
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				const T* row = Pose + b * Stride;
+				for (int64_t i = 0; i < NumBones; ++i)
+				{
+					PoseBoneOps<T>::Compose(row + Offsets[i], Parents[i], GlobalPos + b * NumBones * 3, GlobalRot + b * NumBones * 9, i);
+				}
+			}
+		}
+
+		static void Constrain(const int64_t* Parents, int64_t NumBones, T* Pose, int64_t Batch, int64_t Stride,
+		                      const int64_t* Offsets, const T* RestLength)
+		{
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				T* row = Pose + b * Stride;
+				for (int64_t i = 0; i < NumBones; ++i)
+				{
+					PoseBoneOps<T>::Constrain(row + Offsets[i], Parents[i], RestLength[i]);
+				}
+			}
+		}
+	};
+} // namespace NR
@@ -0,0 +1,72 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/GaitTable.h"
+#include <algorithm>
+
+namespace NR
+{
+	GaitTable::GaitTable(double PhaseMin, double PhaseMax, int32_t PhaseSamples,
+	                     double VelocityMin, double VelocityMax, int32_t VelocitySamples, int32_t Outputs)
+		: PhaseMin(PhaseMin)
+		, PhaseMax(PhaseMax)
+		, PhaseSamples(std::max(PhaseSamples, 2))
+		, VelocityMin(VelocityMin)
+		, VelocityMax(VelocityMax)
+		, VelocitySamples(std::max(VelocitySamples, 2))
+		, Outputs(Outputs)
+	{
+		PhaseStep = (PhaseMax - PhaseMin) / (this->PhaseSamples - 1);
+		VelocityStep = (VelocityMax - VelocityMin) / (this->VelocitySamples - 1);
+		Values.resize(static_cast<size_t>(this->PhaseSamples) * this->VelocitySamples * Outputs, 0.0f);
+	}
+
+	float* GaitTable::Cell(int32_t PhaseIndex, int32_t VelocityIndex)
+	{
+		return Values.data() + (static_cast<size_t>(PhaseIndex) * VelocitySamples + VelocityIndex) * Outputs;
+	}
+
+	bool GaitTable::Lookup(double Phase, double Velocity, float* Out) const
+	{
+		if (!(Phase >= PhaseMin && Phase <= PhaseMax && Velocity >= VelocityMin && Velocity <= VelocityMax))
+		{
+			return false;
+		}
+
+		const double u = PhaseStep > 0.0 ? (Phase - PhaseMin) / PhaseStep : 0.0;
+		const double v = VelocityStep > 0.0 ? (Velocity - VelocityMin) / VelocityStep : 0.0;
+		const int32_t i = std::min(static_cast<int32_t>(u), PhaseSamples - 2);
+		const int32_t j = std::min(static_cast<int32_t>(v), VelocitySamples - 2);
+		const auto a = static_cast<float>(u - i);
+		const auto b = static_cast<float>(v - j);
+
+		const float w00 = (1.0f - a) * (1.0f - b);
+		const float w01 = (1.0f - a) * b;
+		const float w10 = a * (1.0f - b);
+		const float w11 = a * b;
+
+		const float* c00 = Values.data() + (static_cast<size_t>(i) * VelocitySamples + j) * Outputs;
+		const float* c01 = c00 + Outputs;
+		const float* c10 = c00 + static_cast<size_t>(VelocitySamples) * Outputs;
+		const float* c11 = c10 + Outputs;
+
+		// Contiguous corners, vectorized by the compiler
+		for (int32_t f = 0; f < Outputs; ++f)
+		{
+			Out[f] = w00 * c00[f] + w01 * c01[f] + w10 * c10[f] + w11 * c11[f];
+		}
+		return true;
+	}
+} // namespace NR
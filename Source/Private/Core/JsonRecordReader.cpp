@@ -0,0 +1,193 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/JsonRecordReader.h"
+#include <cstring>
+
+namespace NR
+{
+	JsonRecordReader::JsonRecordReader(Selector InSelect, Consumer InConsume)
+		: Select(std::move(InSelect))
+		, Consume(std::move(InConsume))
+	{
+	}
+
+	bool JsonRecordReader::Read(std::istream& Stream)
+	{
+		Frames.clear();
+		CurrentPath.clear();
+		Record = json();
+		Error.clear();
+
+		const bool bOk = json::sax_parse(Stream, this);
+		if (!bOk && Error.empty())
+		{
+			Error = "Parse aborted";
+		}
+		return bOk;
+	}
+
+	bool JsonRecordReader::Matches(const Path& InPath, std::initializer_list<const char*> Pattern)
+	{
+		if (InPath.size() != Pattern.size())
+		{
+			return false;
+		}
+
+		size_t i = 0;
+		for (const char* expected : Pattern)
+		{
+			const Segment& segment = InPath[i++];
+			if (std::strcmp(expected, "*") == 0)
+			{
+				continue;
+			}
+			if (segment.Index >= 0 || segment.Key != expected)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	JsonRecordReader::Segment JsonRecordReader::NextSegment()
+	{
+		if (Frames.empty())
+		{
+			return {}; // Document root
+		}
+
+		Frame& top = Frames.back();
+		if (top.bArray)
+		{
+			return {{}, top.Count++};
+		}
+		return {top.Key, -1};
+	}
+
+	JsonRecordReader::json* JsonRecordReader::Insert(json&& Value)
+	{
+		// Parents are only appended to after their open children closed, so the
+		// returned pointer stays valid for as long as the child frame is open.
+		Frame& top = Frames.back();
+		if (top.bArray)
+		{
+			top.Node->push_back(std::move(Value));
+			return &top.Node->back();
+		}
+		json& slot = (*top.Node)[top.Key];
+		slot = std::move(Value);
+		return &slot;
+	}
+
+	bool JsonRecordReader::Scalar(json&& Value)
+	{
+		const Segment segment = NextSegment();
+		if (!Frames.empty() && Frames.back().Node)
+		{
+			Insert(std::move(Value));
+			return true;
+		}
+
+		const bool bRoot = Frames.empty();
+		if (!bRoot)
+		{
+			CurrentPath.push_back(segment);
+		}
+
+		bool bOk = true;
+		if (Select(CurrentPath))
+		{
+			bOk = Consume(CurrentPath, std::move(Value));
+		}
+
+		if (!bRoot)
+		{
+			CurrentPath.pop_back();
+		}
+		return bOk;
+	}
+
+	bool JsonRecordReader::Open(json&& Value, bool bArray)
+	{
+		const Segment segment = NextSegment();
+		const bool bRoot = Frames.empty();
+
+		json* node = nullptr;
+		if (!bRoot && Frames.back().Node)
+		{
+			node = Insert(std::move(Value));
+		}
+
+		if (!bRoot)
+		{
+			CurrentPath.push_back(segment);
+		}
+
+		if (!node && Select(CurrentPath))
+		{
+			Record = std::move(Value);
+			RecordDepth = Frames.size();
+			node = &Record;
+		}
+
+		Frames.push_back({bArray, 0, {}, node});
+		return true;
+	}
+
+	bool JsonRecordReader::Close()
+	{
+		const Frame closed = std::move(Frames.back());
+		Frames.pop_back();
+
+		bool bOk = true;
+		if (closed.Node == &Record && Frames.size() == RecordDepth)
+		{
+			bOk = Consume(CurrentPath, std::move(Record));
+			Record = json();
+		}
+
+		if (!Frames.empty())
+		{
+			CurrentPath.pop_back();
+		}
+		return bOk;
+	}
+
+	bool JsonRecordReader::null() { return Scalar(json(nullptr)); }
+	bool JsonRecordReader::boolean(bool Value) { return Scalar(json(Value)); }
+	bool JsonRecordReader::number_integer(number_integer_t Value) { return Scalar(json(Value)); }
+	bool JsonRecordReader::number_unsigned(number_unsigned_t Value) { return Scalar(json(Value)); }
+	bool JsonRecordReader::number_float(number_float_t Value, const string_t&) { return Scalar(json(Value)); }
+	bool JsonRecordReader::string(string_t& Value) { return Scalar(json(std::move(Value))); }
+	bool JsonRecordReader::binary(binary_t& Value) { return Scalar(json(std::move(Value))); }
+
+	bool JsonRecordReader::start_object(std::size_t) { return Open(json::object(), false); }
+	bool JsonRecordReader::start_array(std::size_t) { return Open(json::array(), true); }
+	bool JsonRecordReader::end_object() { return Close(); }
+	bool JsonRecordReader::end_array() { return Close(); }
+
+	bool JsonRecordReader::key(string_t& Value)
+	{
+		Frames.back().Key = std::move(Value);
+		return true;
+	}
+
+	bool JsonRecordReader::parse_error(std::size_t Position, const std::string&, const nlohmann::detail::exception& Ex)
+	{
+		Error = "Byte " + std::to_string(Position) + ": " + Ex.what();
+		return false;
+	}
+} // namespace NR
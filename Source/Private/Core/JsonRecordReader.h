@@ -0,0 +1,122 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <istream>
+#include <string>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 4244)
+#pragma warning(disable : 4267)
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4702)
+#pragma warning(disable : 4100)
+#include <nlohmann/json.hpp>
+#pragma warning(pop)
+
+namespace NR
+{
+	/**
+	 * @brief Streams a JSON document and materializes only selected sub-trees ("records").
+	 *
+	 * The document is read through the nlohmann SAX interface. Values outside a record
+	 * are never stored, so peak memory is bounded by the largest record (one binding,
+	 * one rule, one bone chain) rather than by the whole file.
+	 */
+	class JsonRecordReader : public nlohmann::json_sax<nlohmann::ordered_json>
+	{
+	public:
+		using json = nlohmann::ordered_json;
+
+		/**
+		 * @brief Location of a value: object key, or array index (Index >= 0).
+		 */
+		struct Segment
+		{
+			std::string Key;
+			int64_t Index = -1;
+		};
+		using Path = std::vector<Segment>;
+
+		/**
+		 * @brief Returns true when the value at Path must be materialized and consumed.
+		 */
+		using Selector = std::function<bool(const Path&)>;
+
+		/**
+		 * @brief Receives a complete record. Returning false aborts the parse.
+		 */
+		using Consumer = std::function<bool(const Path&, json&&)>;
+
+		JsonRecordReader(Selector InSelect, Consumer InConsume);
+
+		/**
+		 * @brief Parses the stream, dispatching records as they complete.
+		 * @return false on a syntax error or when a consumer aborted, see GetError
+		 */
+		bool Read(std::istream& Stream);
+
+		[[nodiscard]] const std::string& GetError() const { return Error; }
+
+		/**
+		 * @brief Path matches Pattern, where "*" matches any key or index.
+		 */
+		static bool Matches(const Path& InPath, std::initializer_list<const char*> Pattern);
+
+		// --- json_sax ---
+		bool null() override;
+		bool boolean(bool Value) override;
+		bool number_integer(number_integer_t Value) override;
+		bool number_unsigned(number_unsigned_t Value) override;
+		bool number_float(number_float_t Value, const string_t& Text) override;
+		bool string(string_t& Value) override;
+		bool binary(binary_t& Value) override;
+		bool start_object(std::size_t Elements) override;
+		bool key(string_t& Value) override;
+		bool end_object() override;
+		bool start_array(std::size_t Elements) override;
+		bool end_array() override;
+		bool parse_error(std::size_t Position, const std::string& Token, const nlohmann::detail::exception& Ex) override;
+
+	private:
+		struct Frame
+		{
+			bool bArray = false;
+			int64_t Count = 0;
+			std::string Key;
+			json* Node = nullptr; // Container being built, null outside a record
+		};
+
+		Segment NextSegment();
+		json* Insert(json&& Value);
+		bool Scalar(json&& Value);
+		bool Open(json&& Value, bool bArray);
+		bool Close();
+
+		Selector Select;
+		Consumer Consume;
+
+		std::vector<Frame> Frames;
+		Path CurrentPath; // Path of the innermost open container
+		json Record;
+		size_t RecordDepth = 0;
+		std::string Error;
+	};
+} // namespace NR
@@ -0,0 +1,371 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/Kinematics.h"
+#include "Core/FixedKinematicsKernel.h"
+#include "Core/KinematicsKernel.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace NR
+{
+	namespace
+	{
+		class ChainLossFunction : public torch::autograd::Function<ChainLossFunction>
+		{
+		public:
+			static torch::Tensor forward(torch::autograd::AutogradContext* Ctx, const torch::Tensor& LocalPos, const torch::Tensor& LocalQuat, const torch::Tensor& TargetPos, const torch::Tensor& RestLength, const torch::Tensor& LengthWeight, const torch::Tensor& IKWeight, const torch::Tensor& Parents)
+			{
+				auto pos = LocalPos.contiguous();
+				auto quat = LocalQuat.contiguous();
+				auto target = TargetPos.to(pos.dtype()).contiguous();
+				auto restLength = RestLength.to(pos.dtype()).contiguous();
+				auto lengthWeight = LengthWeight.to(pos.dtype()).contiguous();
+				auto ikWeight = IKWeight.to(pos.dtype()).contiguous();
+				auto parents = Parents.to(torch::kLong).contiguous();
+
+				Ctx->save_for_backward({pos, quat, target, restLength, lengthWeight, ikWeight, parents});
+
+				double loss = 0.0;
+				AT_DISPATCH_FLOATING_TYPES(pos.scalar_type(), "NRChainLossForward", [&] {
+					ChainLossKernel<scalar_t> kernel(parents.data_ptr<int64_t>(), pos.size(1), pos.size(0));
+					loss = kernel.Forward(pos.data_ptr<scalar_t>(), quat.data_ptr<scalar_t>(), target.data_ptr<scalar_t>(),
+					                      restLength.data_ptr<scalar_t>(), lengthWeight.data_ptr<scalar_t>(), ikWeight.data_ptr<scalar_t>());
+				});
+
+				return torch::scalar_tensor(loss, pos.options());
+			}
+
+			static torch::autograd::variable_list backward(torch::autograd::AutogradContext* Ctx, torch::autograd::variable_list GradOutputs)
+			{
+				auto saved = Ctx->get_saved_variables();
+				auto& pos = saved[0];
+				auto& quat = saved[1];
+				auto& parents = saved[6];
+
+				auto gradPos = torch::empty_like(pos);
+				auto gradQuat = torch::empty_like(quat);
+				const double grad = GradOutputs[0].item<double>();
+
+				AT_DISPATCH_FLOATING_TYPES(pos.scalar_type(), "NRChainLossBackward", [&] {
+					// Recompute the forward transforms instead of keeping them alive between passes
+					ChainLossKernel<scalar_t> kernel(parents.data_ptr<int64_t>(), pos.size(1), pos.size(0));
+					kernel.Forward(pos.data_ptr<scalar_t>(), quat.data_ptr<scalar_t>(), saved[2].data_ptr<scalar_t>(),
+					               saved[3].data_ptr<scalar_t>(), saved[4].data_ptr<scalar_t>(), saved[5].data_ptr<scalar_t>());
+					kernel.Backward(static_cast<scalar_t>(grad), gradPos.data_ptr<scalar_t>(), gradQuat.data_ptr<scalar_t>());
+				});
+
+				return {gradPos, gradQuat, torch::Tensor(), torch::Tensor(), torch::Tensor(), torch::Tensor(), torch::Tensor()};
+			}
+		};
+
+		template<typename Topology>
+		NRFixedKernel MakeFixedKernel(const char* Name)
+		{
+			using Kernel = FixedPoseKernel<Topology, float>;
+			return {Name, {Topology::Parents.begin(), Topology::Parents.end()}, &Kernel::Forward, &Kernel::Constrain};
+		}
+
+		// Topologies with a compiled kernel, matched against every layout built from a profile
+		const std::vector<NRFixedKernel>& FixedKernels()
+		{
+			static const std::vector<NRFixedKernel> kernels = {
+				MakeFixedKernel<ChainTopology<3, 3>>("Legs3"),
+				MakeFixedKernel<ChainTopology<4, 4>>("Legs4"),
+				MakeFixedKernel<ChainTopology<3, 3, 3, 3>>("Limbs3"),
+				MakeFixedKernel<ChainTopology<4, 4, 4, 4>>("Limbs4"),
+			};
+			return kernels;
+		}
+	} // namespace
+
+	NRKinematicLayout Kinematics::BuildLayout(const NRSkeleton& Skeleton)
+	{
+		NRKinematicLayout layout;
+		std::vector<torch::Tensor> restPos;
+		std::vector<torch::Tensor> restRot;
+		std::vector<torch::Tensor> limitMin;
+		std::vector<torch::Tensor> limitMax;
+
+		const float unbounded = std::numeric_limits<float>::infinity();
+		auto addBone = [&](const NRSkeleton::Bone& bone, int64_t parent) {
+			layout.Names.push_back(bone.Name);
+			layout.Parents.push_back(parent);
+			layout.Offsets.push_back(bone.Offset);
+			restPos.push_back(bone.RestPose.Pos.defined() ? bone.RestPose.Pos.to(torch::kFloat).reshape({3}) : torch::zeros({3}));
+			restRot.push_back(bone.RestPose.Rot.defined() ? bone.RestPose.Rot.to(torch::kFloat).reshape({4}) : torch::tensor({0.0f, 0.0f, 0.0f, 1.0f}));
+			limitMin.push_back(bone.Limits.Min.defined() ? bone.Limits.Min.to(torch::kFloat).reshape({3}) : torch::full({3}, -unbounded));
+			limitMax.push_back(bone.Limits.Max.defined() ? bone.Limits.Max.to(torch::kFloat).reshape({3}) : torch::full({3}, unbounded));
+			return static_cast<int64_t>(layout.Names.size()) - 1;
+		};
+
+		// Chains hang off the bone whose ChildrenIndices lists them, the Parent when none does
+		const int64_t numChains = static_cast<int64_t>(Skeleton.Rest.size());
+		std::vector<bool> claimed(numChains, false);
+		auto claim = [&](const NRSkeleton::Bone& bone) {
+			for (const int32_t child : bone.ChildrenIndices)
+			{
+				if (child >= 0 && child < numChains)
+				{
+					claimed[child] = true;
+				}
+			}
+		};
+		for (const auto& chain : Skeleton.Rest)
+		{
+			std::for_each(chain.begin(), chain.end(), claim);
+		}
+
+		// Breadth-first over chains so every bone comes after its parent
+		std::vector<int64_t> chainParent(numChains, -1);
+		std::vector<int64_t> queue;
+		std::vector<bool> queued(numChains, false);
+		auto enqueue = [&](int64_t chain, int64_t parent) {
+			if (!queued[chain])
+			{
+				queued[chain] = true;
+				chainParent[chain] = parent;
+				queue.push_back(chain);
+			}
+		};
+
+		const int64_t root = addBone(Skeleton.Parent, -1);
+		for (int64_t c = 0; c < numChains; ++c)
+		{
+			const auto& children = Skeleton.Parent.ChildrenIndices;
+			if (!claimed[c] || std::find(children.begin(), children.end(), c) != children.end())
+			{
+				enqueue(c, root);
+			}
+		}
+
+		for (int64_t next = 0; next < numChains; ++next)
+		{
+			if (next == static_cast<int64_t>(queue.size()))
+			{
+				// Only reachable through a cycle of ChildrenIndices
+				const auto orphan = std::find(queued.begin(), queued.end(), false) - queued.begin();
+				std::cerr << "[Kinematics] Chain " << orphan << " is not reachable from the Parent, attached to it" << std::endl;
+				enqueue(orphan, root);
+			}
+
+			const auto& chain = Skeleton.Rest[queue[next]];
+			int64_t parent = chainParent[queue[next]];
+			for (const auto& bone : chain)
+			{
+				parent = addBone(bone, parent);
+				for (const int32_t child : bone.ChildrenIndices)
+				{
+					if (child >= 0 && child < numChains)
+					{
+						enqueue(child, parent);
+					}
+				}
+			}
+
+			if (!chain.empty())
+			{
+				layout.EndEffectors.push_back(parent);
+			}
+		}
+
+		const int64_t numBones = layout.NumBones();
+		std::vector<int64_t> posIndex;
+		std::vector<int64_t> rotIndex;
+		posIndex.reserve(numBones * 3);
+		rotIndex.reserve(numBones * 4);
+		for (const auto offset : layout.Offsets)
+		{
+			for (int64_t k = 0; k < 3; ++k)
+			{
+				posIndex.push_back(offset + k);
+			}
+			for (int64_t k = 3; k < 7; ++k)
+			{
+				rotIndex.push_back(offset + k);
+			}
+		}
+
+		const auto indexOptions = torch::TensorOptions().dtype(torch::kLong);
+		layout.PosIndex = torch::tensor(posIndex, indexOptions);
+		layout.RotIndex = torch::tensor(rotIndex, indexOptions);
+		layout.EndIndex = torch::tensor(layout.EndEffectors, indexOptions);
+		layout.EndMask = torch::zeros({numBones}).index_fill_(0, layout.EndIndex, 1.0f);
+		layout.ParentIndex = torch::tensor(layout.Parents, indexOptions);
+		layout.RestPos = torch::stack(restPos);
+		layout.RestRot = torch::stack(restRot);
+		layout.RestLength = layout.RestPos.norm(2, -1);
+		layout.LimitMin = torch::stack(limitMin);
+		layout.LimitMax = torch::stack(limitMax);
+
+		// Group bones by depth, parents are always declared before their children
+		std::vector<int64_t> depth(numBones, 0);
+		std::vector<std::vector<int64_t>> levels;
+		std::vector<std::vector<int64_t>> levelParents;
+		for (int64_t i = 0; i < numBones; ++i)
+		{
+			const int64_t parent = layout.Parents[i];
+			if (parent < 0)
+			{
+				continue;
+			}
+
+			depth[i] = depth[parent] + 1;
+			if (static_cast<size_t>(depth[i]) > levels.size())
+			{
+				levels.resize(depth[i]);
+				levelParents.resize(depth[i]);
+			}
+			levels[depth[i] - 1].push_back(i);
+			levelParents[depth[i] - 1].push_back(parent);
+		}
+
+		for (size_t l = 0; l < levels.size(); ++l)
+		{
+			layout.LevelBones.push_back(torch::tensor(levels[l], indexOptions));
+			layout.LevelParents.push_back(torch::tensor(levelParents[l], indexOptions));
+		}
+
+		layout.Fixed = FindFixedKernel(layout.Parents);
+		return layout;
+	}
+
+	const NRFixedKernel* Kinematics::FindFixedKernel(const std::vector<int64_t>& Parents)
+	{
+		for (const auto& kernel : FixedKernels())
+		{
+			if (kernel.Parents == Parents)
+			{
+				return &kernel;
+			}
+		}
+		return nullptr;
+	}
+
+	void Kinematics::ForwardPose(const NRKinematicLayout& Layout, const float* Pose, int64_t Batch, int64_t Stride, float* GlobalPos, float* GlobalRot)
+	{
+		if (Layout.Fixed)
+		{
+			Layout.Fixed->Forward(Pose, Batch, Stride, Layout.Offsets.data(), GlobalPos, GlobalRot);
+			return;
+		}
+		GenericPoseKernel<float>::Forward(Layout.Parents.data(), Layout.NumBones(), Pose, Batch, Stride, Layout.Offsets.data(), GlobalPos, GlobalRot);
+	}
+
+	void Kinematics::ConstrainPose(const NRKinematicLayout& Layout, float* Pose, int64_t Batch, int64_t Stride)
+	{
+		auto restLength = Layout.RestLength.contiguous();
+		if (Layout.Fixed)
+		{
+			Layout.Fixed->Constrain(Pose, Batch, Stride, Layout.Offsets.data(), restLength.data_ptr<float>());
+			return;
+		}
+		GenericPoseKernel<float>::Constrain(Layout.Parents.data(), Layout.NumBones(), Pose, Batch, Stride, Layout.Offsets.data(), restLength.data_ptr<float>());
+	}
+
+	torch::Tensor Kinematics::QuatToMat(const torch::Tensor& Q)
+	{
+		auto qn = Q / (Q.norm(2, -1, true) + 1e-8);
+
+		auto x = qn.select(-1, 0);
+		auto y = qn.select(-1, 1);
+		auto z = qn.select(-1, 2);
+		auto w = qn.select(-1, 3);
+
+		auto xx = x * x, yy = y * y, zz = z * z;
+		auto xy = x * y, xz = x * z, yz = y * z;
+		auto wx = w * x, wy = w * y, wz = w * z;
+
+		auto m = torch::stack({1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),
+		                       2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),
+		                       2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy)},
+		                      -1);
+
+		auto shape = Q.sizes().vec();
+		shape.back() = 3;
+		shape.push_back(3);
+		return m.view(shape);
+	}
+
+	torch::Tensor Kinematics::GatherPos(const NRKinematicLayout& Layout, const torch::Tensor& Pose)
+	{
+		auto batch = Pose.dim() > 1 ? Pose : Pose.unsqueeze(0);
+		return batch.index_select(1, Layout.PosIndex.to(batch.device())).view({batch.size(0), Layout.NumBones(), 3});
+	}
+
+	torch::Tensor Kinematics::GatherQuat(const NRKinematicLayout& Layout, const torch::Tensor& Pose)
+	{
+		auto batch = Pose.dim() > 1 ? Pose : Pose.unsqueeze(0);
+		return batch.index_select(1, Layout.RotIndex.to(batch.device())).view({batch.size(0), Layout.NumBones(), 4});
+	}
+
+	void Kinematics::Compose(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalRot, torch::Tensor& OutPos, torch::Tensor& OutRot)
+	{
+		// Roots keep their local transform, every level below is overwritten in order
+		OutPos = LocalPos;
+		OutRot = LocalRot;
+
+		for (size_t l = 0; l < Layout.LevelBones.size(); ++l)
+		{
+			auto bones = Layout.LevelBones[l].to(LocalPos.device());
+			auto parents = Layout.LevelParents[l].to(LocalPos.device());
+
+			auto pPos = OutPos.index_select(1, parents);
+			auto pRot = OutRot.index_select(1, parents);
+
+			// pChild = pParent + mParent * pLocal, mChild = mParent * mLocal
+			auto cPos = pPos + torch::matmul(pRot, LocalPos.index_select(1, bones).unsqueeze(-1)).squeeze(-1);
+			auto cRot = torch::matmul(pRot, LocalRot.index_select(1, bones));
+
+			OutPos = OutPos.index_copy(1, bones, cPos);
+			OutRot = OutRot.index_copy(1, bones, cRot);
+		}
+	}
+
+	NRFKResult Kinematics::Forward(const NRKinematicLayout& Layout, const torch::Tensor& Pose)
+	{
+		NRFKResult res;
+		res.LocalPos = GatherPos(Layout, Pose);
+		res.LocalQuat = GatherQuat(Layout, Pose);
+		res.LocalRot = QuatToMat(res.LocalQuat);
+		Compose(Layout, res.LocalPos, res.LocalRot, res.GlobalPos, res.GlobalRot);
+		return res;
+	}
+
+	torch::Tensor Kinematics::ChainLoss(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalQuat, const torch::Tensor& TargetPos, const torch::Tensor& LengthWeight, const torch::Tensor& IKWeight)
+	{
+		if (!LocalPos.device().is_cpu() || !LocalQuat.device().is_cpu())
+		{
+			return ChainLossReference(Layout, LocalPos, LocalQuat, TargetPos, LengthWeight, IKWeight);
+		}
+
+		return ChainLossFunction::apply(LocalPos, LocalQuat, TargetPos.detach(), Layout.RestLength, LengthWeight.detach(), IKWeight.detach(), Layout.ParentIndex);
+	}
+
+	torch::Tensor Kinematics::ChainLossReference(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalQuat, const torch::Tensor& TargetPos, const torch::Tensor& LengthWeight, const torch::Tensor& IKWeight)
+	{
+		torch::Tensor globalPos;
+		torch::Tensor globalRot;
+		Compose(Layout, LocalPos, QuatToMat(LocalQuat), globalPos, globalRot);
+
+		auto options = LocalPos.options();
+		auto restLength = Layout.RestLength.to(options);
+		auto lengthLoss = (LocalPos.norm(2, -1) - restLength).pow(2).mean(0);
+		auto ikLoss = (globalPos - TargetPos.to(options)).pow(2).mean({0, 2});
+
+		return (lengthLoss * LengthWeight.to(options)).sum() + (ikLoss * IKWeight.to(options)).sum();
+	}
+} // namespace NR
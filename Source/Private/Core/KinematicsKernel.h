@@ -0,0 +1,337 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Core.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief CPU kernel of the fused skeleton FK + bone length + end effector loss.
+	 *
+	 * Inputs are [B, NBones, C] row-major buffers. Internally everything is transposed to
+	 * bone/component-major order with the batch innermost, so every loop over the batch
+	 * runs on contiguous lanes without dependencies and is vectorized by the compiler.
+	 *
+	 * Loss = sum_i LengthWeight_i * mean_b (|p_i| - RestLength_i)^2
+	 *      + sum_i IKWeight_i * mean_{b,xyz} (P_i - Target_i)^2
+	 * where p_i is the local and P_i the global position of bone i.
+	 */
+	template<FloatingPoint T>
+	class ChainLossKernel
+	{
+	public:
+		static constexpr T Epsilon = static_cast<T>(1e-8);
+
+		ChainLossKernel(const int64_t* InParents, int64_t InNumBones, int64_t InBatch)
+			: Parents(InParents)
+			, NumBones(InNumBones)
+			, Batch(InBatch)
+		{
+		}
+
+		/**
+		 * @brief Evaluates the loss and keeps the intermediate transforms for Backward.
+		 */
+		T Forward(const T* LocalPos, const T* LocalQuat, const T* TargetPos, const T* RestLength, const T* LengthWeight, const T* IKWeight)
+		{
+			const int64_t B = Batch;
+			Weights = {RestLength, LengthWeight, IKWeight};
+
+			Load(LocalPos, 3, Pos);
+			Load(LocalQuat, 4, Rot);
+			Load(TargetPos, 3, Target);
+			Scale.assign(NumBones * B, T(0));
+			Norm.assign(NumBones * B, T(0));
+			Local.assign(NumBones * 9 * B, T(0));
+			GlobalRot.assign(NumBones * 9 * B, T(0));
+			GlobalPos.assign(NumBones * 3 * B, T(0));
+
+			T loss = T(0);
+			for (int64_t i = 0; i < NumBones; ++i)
+			{
+				const T* qx = &Rot[(i * 4 + 0) * B];
+				const T* qy = &Rot[(i * 4 + 1) * B];
+				const T* qz = &Rot[(i * 4 + 2) * B];
+				const T* qw = &Rot[(i * 4 + 3) * B];
+				T* norm = &Norm[i * B];
+				T* scale = &Scale[i * B];
+				T* m = &Local[i * 9 * B];
+
+				for (int64_t b = 0; b < B; ++b)
+				{
+					const T n = std::sqrt(qx[b] * qx[b] + qy[b] * qy[b] + qz[b] * qz[b] + qw[b] * qw[b]);
+					const T s = n + Epsilon;
+					const T x = qx[b] / s, y = qy[b] / s, z = qz[b] / s, w = qw[b] / s;
+					norm[b] = n;
+					scale[b] = s;
+
+					m[0 * B + b] = 1 - 2 * (y * y + z * z);
+					m[1 * B + b] = 2 * (x * y - w * z);
+					m[2 * B + b] = 2 * (x * z + w * y);
+					m[3 * B + b] = 2 * (x * y + w * z);
+					m[4 * B + b] = 1 - 2 * (x * x + z * z);
+					m[5 * B + b] = 2 * (y * z - w * x);
+					m[6 * B + b] = 2 * (x * z - w * y);
+					m[7 * B + b] = 2 * (y * z + w * x);
+					m[8 * B + b] = 1 - 2 * (x * x + y * y);
+				}
+
+				T* r = &GlobalRot[i * 9 * B];
+				T* gp = &GlobalPos[i * 3 * B];
+				const T* p = &Pos[i * 3 * B];
+				const int64_t parent = Parents[i];
+				if (parent < 0)
+				{
+					std::copy(m, m + 9 * B, r);
+					std::copy(p, p + 3 * B, gp);
+				}
+				else
+				{
+					const T* rp = &GlobalRot[parent * 9 * B];
+					const T* pp = &GlobalPos[parent * 3 * B];
+					for (int64_t a = 0; a < 3; ++a)
+					{
+						for (int64_t c = 0; c < 3; ++c)
+						{
+							for (int64_t b = 0; b < B; ++b)
+							{
+								r[(a * 3 + c) * B + b] = rp[(a * 3 + 0) * B + b] * m[(0 * 3 + c) * B + b]
+								                         + rp[(a * 3 + 1) * B + b] * m[(1 * 3 + c) * B + b]
+								                         + rp[(a * 3 + 2) * B + b] * m[(2 * 3 + c) * B + b];
+							}
+						}
+
+						for (int64_t b = 0; b < B; ++b)
+						{
+							gp[a * B + b] = pp[a * B + b]
+							                + rp[(a * 3 + 0) * B + b] * p[0 * B + b]
+							                + rp[(a * 3 + 1) * B + b] * p[1 * B + b]
+							                + rp[(a * 3 + 2) * B + b] * p[2 * B + b];
+						}
+					}
+				}
+
+				const T* t = &Target[i * 3 * B];
+				T ikSum = T(0);
+				T lengthSum = T(0);
+				for (int64_t b = 0; b < B; ++b)
+				{
+					const T dx = gp[0 * B + b] - t[0 * B + b];
+					const T dy = gp[1 * B + b] - t[1 * B + b];
+					const T dz = gp[2 * B + b] - t[2 * B + b];
+					ikSum += dx * dx + dy * dy + dz * dz;
+
+					const T len = std::sqrt(p[0 * B + b] * p[0 * B + b] + p[1 * B + b] * p[1 * B + b] + p[2 * B + b] * p[2 * B + b]);
+					const T dl = len - RestLength[i];
+					lengthSum += dl * dl;
+				}
+
+				loss += IKWeight[i] * ikSum / T(3 * B) + LengthWeight[i] * lengthSum / T(B);
+			}
+
+			return loss;
+		}
+
+		/**
+		 * @brief Propagates the loss gradient back to the local positions and quaternions.
+		 * @param Grad Upstream gradient of the scalar loss
+		 * @param OutPosGrad Receives [B, NBones, 3]
+		 * @param OutQuatGrad Receives [B, NBones, 4]
+		 */
+		void Backward(T Grad, T* OutPosGrad, T* OutQuatGrad)
+		{
+			const int64_t B = Batch;
+			const auto [RestLength, LengthWeight, IKWeight] = Weights;
+
+			std::vector<T> gGlobalPos(NumBones * 3 * B, T(0));
+			std::vector<T> gGlobalRot(NumBones * 9 * B, T(0));
+			std::vector<T> gPos(NumBones * 3 * B, T(0));
+			std::vector<T> gRot(NumBones * 4 * B, T(0));
+			std::vector<T> gLocal(9 * B, T(0));
+
+			for (int64_t i = 0; i < NumBones; ++i)
+			{
+				const T ikScale = Grad * IKWeight[i] * T(2) / T(3 * B);
+				const T lengthScale = Grad * LengthWeight[i] * T(2) / T(B);
+				const T* gp = &GlobalPos[i * 3 * B];
+				const T* t = &Target[i * 3 * B];
+				const T* p = &Pos[i * 3 * B];
+				T* ggp = &gGlobalPos[i * 3 * B];
+				T* gpos = &gPos[i * 3 * B];
+
+				for (int64_t b = 0; b < B; ++b)
+				{
+					const T len = std::sqrt(p[0 * B + b] * p[0 * B + b] + p[1 * B + b] * p[1 * B + b] + p[2 * B + b] * p[2 * B + b]);
+					const T k = len > T(0) ? lengthScale * (len - RestLength[i]) / len : T(0);
+					for (int64_t a = 0; a < 3; ++a)
+					{
+						ggp[a * B + b] = ikScale * (gp[a * B + b] - t[a * B + b]);
+						gpos[a * B + b] = k * p[a * B + b];
+					}
+				}
+			}
+
+			// Children always come after their parents, so a reverse sweep sees complete gradients
+			for (int64_t i = NumBones - 1; i >= 0; --i)
+			{
+				const T* m = &Local[i * 9 * B];
+				const T* p = &Pos[i * 3 * B];
+				const T* ggp = &gGlobalPos[i * 3 * B];
+				const T* ggr = &gGlobalRot[i * 9 * B];
+				T* gpos = &gPos[i * 3 * B];
+				const int64_t parent = Parents[i];
+
+				if (parent < 0)
+				{
+					for (int64_t k = 0; k < 3 * B; ++k)
+					{
+						gpos[k] += ggp[k];
+					}
+					std::copy(ggr, ggr + 9 * B, gLocal.begin());
+				}
+				else
+				{
+					const T* rp = &GlobalRot[parent * 9 * B];
+					T* ggpParent = &gGlobalPos[parent * 3 * B];
+					T* ggrParent = &gGlobalRot[parent * 9 * B];
+
+					for (int64_t a = 0; a < 3; ++a)
+					{
+						for (int64_t c = 0; c < 3; ++c)
+						{
+							for (int64_t b = 0; b < B; ++b)
+							{
+								// P = Pp + Rp * p  ->  dRp += gP p^T, dp += Rp^T gP
+								// R = Rp * M       ->  dRp += gR M^T, dM = Rp^T gR
+								ggrParent[(a * 3 + c) * B + b] += ggp[a * B + b] * p[c * B + b]
+								                                  + ggr[(a * 3 + 0) * B + b] * m[(c * 3 + 0) * B + b]
+								                                  + ggr[(a * 3 + 1) * B + b] * m[(c * 3 + 1) * B + b]
+								                                  + ggr[(a * 3 + 2) * B + b] * m[(c * 3 + 2) * B + b];
+
+								gLocal[(a * 3 + c) * B + b] = rp[(0 * 3 + a) * B + b] * ggr[(0 * 3 + c) * B + b]
+								                              + rp[(1 * 3 + a) * B + b] * ggr[(1 * 3 + c) * B + b]
+								                              + rp[(2 * 3 + a) * B + b] * ggr[(2 * 3 + c) * B + b];
+							}
+						}
+
+						for (int64_t b = 0; b < B; ++b)
+						{
+							ggpParent[a * B + b] += ggp[a * B + b];
+							gpos[a * B + b] += rp[(0 * 3 + a) * B + b] * ggp[0 * B + b]
+							                   + rp[(1 * 3 + a) * B + b] * ggp[1 * B + b]
+							                   + rp[(2 * 3 + a) * B + b] * ggp[2 * B + b];
+						}
+					}
+				}
+
+				QuatBackward(i, gLocal.data(), &gRot[i * 4 * B]);
+			}
+
+			Store(gPos, 3, OutPosGrad);
+			Store(gRot, 4, OutQuatGrad);
+		}
+
+	private:
+		void Load(const T* Src, int64_t Components, std::vector<T>& Dst) const
+		{
+			Dst.resize(NumBones * Components * Batch);
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				for (int64_t i = 0; i < NumBones; ++i)
+				{
+					for (int64_t c = 0; c < Components; ++c)
+					{
+						Dst[(i * Components + c) * Batch + b] = Src[(b * NumBones + i) * Components + c];
+					}
+				}
+			}
+		}
+
+		void Store(const std::vector<T>& Src, int64_t Components, T* Dst) const
+		{
+			for (int64_t b = 0; b < Batch; ++b)
+			{
+				for (int64_t i = 0; i < NumBones; ++i)
+				{
+					for (int64_t c = 0; c < Components; ++c)
+					{
+						Dst[(b * NumBones + i) * Components + c] = Src[(i * Components + c) * Batch + b];
+					}
+				}
+			}
+		}
+
+		// dM/dq of the normalized quaternion to matrix conversion
+		void QuatBackward(int64_t Bone, const T* G, T* OutGrad) const
+		{
+			const int64_t B = Batch;
+			const T* qx = &Rot[(Bone * 4 + 0) * B];
+			const T* qy = &Rot[(Bone * 4 + 1) * B];
+			const T* qz = &Rot[(Bone * 4 + 2) * B];
+			const T* qw = &Rot[(Bone * 4 + 3) * B];
+			const T* norm = &Norm[Bone * B];
+			const T* scale = &Scale[Bone * B];
+
+			for (int64_t b = 0; b < B; ++b)
+			{
+				const T s = scale[b];
+				const T x = qx[b] / s, y = qy[b] / s, z = qz[b] / s, w = qw[b] / s;
+				const T g00 = G[0 * B + b], g01 = G[1 * B + b], g02 = G[2 * B + b];
+				const T g10 = G[3 * B + b], g11 = G[4 * B + b], g12 = G[5 * B + b];
+				const T g20 = G[6 * B + b], g21 = G[7 * B + b], g22 = G[8 * B + b];
+
+				const T gx = 2 * (y * (g01 + g10) + z * (g02 + g20) + w * (g21 - g12)) - 4 * x * (g11 + g22);
+				const T gy = 2 * (x * (g01 + g10) + w * (g02 - g20) + z * (g12 + g21)) - 4 * y * (g00 + g22);
+				const T gz = 2 * (w * (g10 - g01) + x * (g02 + g20) + y * (g12 + g21)) - 4 * z * (g00 + g11);
+				const T gw = 2 * (z * (g10 - g01) + y * (g02 - g20) + x * (g21 - g12));
+
+				// n = q / (|q| + eps)  ->  dq = gn / s - q (q . gn) / (|q| s^2)
+				const T dot = qx[b] * gx + qy[b] * gy + qz[b] * gz + qw[b] * gw;
+				const T k = norm[b] > T(0) ? dot / (norm[b] * s * s) : T(0);
+				OutGrad[0 * B + b] = gx / s - qx[b] * k;
+				OutGrad[1 * B + b] = gy / s - qy[b] * k;
+				OutGrad[2 * B + b] = gz / s - qz[b] * k;
+				OutGrad[3 * B + b] = gw / s - qw[b] * k;
+			}
+		}
+
+		struct WeightRefs
+		{
+			const T* RestLength = nullptr;
+			const T* LengthWeight = nullptr;
+			const T* IKWeight = nullptr;
+		};
+
+		const int64_t* Parents;
+		int64_t NumBones;
+		int64_t Batch;
+		WeightRefs Weights;
+
+		std::vector<T> Pos;
+		std::vector<T> Rot;
+		std::vector<T> Target;
+		std::vector<T> Norm;
+		std::vector<T> Scale;
+		std::vector<T> Local;
+		std::vector<T> GlobalRot;
+		std::vector<T> GlobalPos;
+	};
+} // namespace NR
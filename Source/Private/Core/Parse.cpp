@@ -15,8 +15,13 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Core/Parse.h"
+#include "Core/ProfileCache.h"
+#include "Core/JsonRecordReader.h"
+#include <algorithm>
 #include <fstream>
+#include <typeinfo>
 #include <iostream>
+#include <unordered_map>
 
 #ifdef MUP_STRING_TYPE
 #define MUP_STRING_TYPE std::string
@@ -48,11 +53,183 @@ using namespace mu;
 
 namespace NR
 {
+	namespace
+	{
+		std::shared_ptr<NRParameterTable> ParseParameters(const json& Params)
+		{
+			auto table = std::make_shared<NRParameterTable>();
+			if (Params.contains("Constants"))
+			{
+				for (auto& el : Params["Constants"].items())
+				{
+					table->Constants[el.key()] = el.value().is_number() ? el.value().get<double>() : 0.0;
+				}
+			}
+
+			if (Params.contains("Variables"))
+			{
+				for (auto& el : Params["Variables"].items())
+				{
+					NRVars vars;
+					vars.Name = el.key();
+					vars.List = el.value().get<std::vector<std::string>>();
+					table->Variables.push_back(vars);
+				}
+			}
+			return table;
+		}
+
+		RotationLimit ParseLimits(const json& lim)
+		{
+			RotationLimit limits;
+			limits.Min = torch::tensor({
+				DegToRad(lim.value("MinX", -360.0f)),
+				DegToRad(lim.value("MinY", -360.0f)),
+				DegToRad(lim.value("MinZ", -360.0f))
+			});
+			limits.Max = torch::tensor({
+				DegToRad(lim.value("MaxX", 360.0f)),
+				DegToRad(lim.value("MaxY", 360.0f)),
+				DegToRad(lim.value("MaxZ", 360.0f))
+			});
+			return limits;
+		}
+
+		NRRule ParseRule(const json& Rule)
+		{
+			NRRule rule;
+			rule.Name = Rule.at("Name");
+
+			// Logic
+			if (Rule.contains("Logic"))
+			{
+				for (auto& el : Rule.at("Logic").items())
+				{
+					NRLogic logic;
+					logic.Name = el.key();
+					logic.Expr = el.value();
+					rule.Logic.push_back(logic);
+				}
+			}
+
+			// Rotation Limits
+			if (Rule.contains("Limits"))
+			{
+				rule.Limits = ParseLimits(Rule.at("Limits"));
+			}
+
+			if (Rule.contains("Phases"))
+			{
+				for (auto& phase_item : Rule.at("Phases"))
+				{
+					NRRule::Phase phase;
+					phase.Id = phase_item.at("id");
+					phase.Condition = phase_item.at("condition");
+
+					for (auto& el2 : phase_item.items())
+					{
+						if (el2.key() != "condition" && el2.key() != "id")
+						{
+							NRFormula formula;
+							formula.Name = el2.key();
+							formula.Expr = el2.value().get<std::string>();
+							phase.Formulas.push_back(formula);
+						}
+					}
+					rule.Phases.push_back(phase);
+				}
+			}
+			return rule;
+		}
+
+		NRSkeleton::Bone ParseBone(const json& b, IQuat* OutQuat)
+		{
+			NRSkeleton::Bone bone;
+			bone.Name = b.value("Name", "");
+			bone.Size = b.value("Size", 0);
+			bone.Offset = b.value("Offset", 0);
+
+			// Initialize default tensors to avoid "None" tensor errors
+			bone.RestPose.Pos = torch::zeros({3}, torch::kFloat32);
+			bone.RestPose.Rot = torch::tensor({0.0f, 0.0f, 0.0f, 1.0f}, torch::kFloat32);
+			bone.Limits.Min = torch::tensor({-3.14159f, -3.14159f, -3.14159f}, torch::kFloat32);
+			bone.Limits.Max = torch::tensor({3.14159f, 3.14159f, 3.14159f}, torch::kFloat32);
+
+			auto getFloat = [](const json& p, const std::string& key) {
+				auto val = p.value(key, "0.0");
+				std::replace(val.begin(), val.end(), ',', '.');
+				try {
+					return std::stof(val);
+				} catch (...) {
+					return 0.0f;
+				}
+			};
+			if (b.contains("Pose")) {
+				auto& p = b["Pose"];
+
+				bone.RestPose.Pos = torch::tensor({
+					getFloat(p, "x") * 0.01,
+					getFloat(p, "y") * 0.01,
+					getFloat(p, "z") * 0.01
+				});
+
+				if (p.contains("Pitch") || p.contains("Yaw") || p.contains("Roll")) {
+					float pitch = DegToRad(getFloat(p, "Pitch"));
+					float yaw   = DegToRad(getFloat(p, "Yaw"));
+					float roll  = DegToRad(getFloat(p, "Roll"));
+
+					if (OutQuat) {
+						bone.RestPose.Rot = OutQuat->ToQuat(pitch, yaw, roll);
+						std::cout << "Quat: " << pitch << ", " << yaw << ", " << roll << std::endl;
+					} else {
+						std::cerr << "Warning: OutQuat is null, skipping rotation parsing for bone " << bone.Name << std::endl;
+					}
+				}
+			}
+
+			if (b.contains("Limits")) {
+				bone.Limits = ParseLimits(b["Limits"]);
+			}
+
+			if (b.contains("Childrens")) {
+				bone.ChildrenIndices = b["Childrens"].get<std::vector<int32_t>>();
+			}
+			return bone;
+		}
+	} // namespace
+
 	bool Parse::LoadProfileFromJson(const std::string& FilePath, NRModelProfile& OutProfile)
 	{
 		return LoadIKFromJson(FilePath, OutProfile);
 	}
 
+	bool Parse::LoadProfileCached(const std::string& IKPath, const std::string& SKPath, const std::string& TWPath,
+	                              const std::string& CachePath, NRModelProfile& OutProfile, IQuat* OutQuat)
+	{
+		// Rest rotations are stored converted, a different converter needs a new cache
+		const std::string converter = OutQuat ? typeid(*OutQuat).name() : "";
+		const uint64_t hash = ProfileCache::HashFiles({IKPath, SKPath, TWPath}, converter);
+		if (hash != 0 && ProfileCache::Read(CachePath, hash, OutProfile))
+		{
+			return true;
+		}
+
+		NRModelProfile profile;
+		if (!LoadIKFromJson(IKPath, profile)
+			|| !LoadSKFromJson(SKPath, profile.Skeleton, OutQuat)
+			|| !LoadTWFromJson(TWPath, profile.TrainingWeights))
+		{
+			return false;
+		}
+
+		if (hash != 0)
+		{
+			ProfileCache::Write(CachePath, profile, hash);
+		}
+		OutProfile = std::move(profile);
+		return true;
+	}
+
 	bool Parse::LoadIKFromJson(const std::string& FilePath, NRModelProfile& OutProfile)
 	{
 		std::ifstream file(FilePath);
@@ -62,133 +239,86 @@ namespace NR
 
 		try
 		{
-			json j;
-			file >> j;
-			OutProfile.ProfileName = j.value("Profile", "Unknown");
-
-			if (j.contains("Schema"))
-			{
-				auto schema = j["Schema"];
-
-				// --- INPUTS & OUTPUTS ---
-				if (schema.contains("Inputs"))
-				{
-					for (const auto& item : schema["Inputs"])
+			// Bindings may come before the rules they target, they are resolved once the file is read
+			std::vector<NRBinding> bindings;
+			std::unordered_map<std::string, NRRule> rules;
+			std::shared_ptr<const NRParameterTable> parameters;
+
+			OutProfile.ProfileName = "Unknown";
+			JsonRecordReader reader(
+				[](const JsonRecordReader::Path& path) {
+					return JsonRecordReader::Matches(path, {"Profile"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Inputs", "*"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Outputs", "*"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Parameters"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Bindings", "*"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Rules", "*"});
+				},
+				[&](const JsonRecordReader::Path& path, json&& value) {
+					if (path.size() == 1)
 					{
-						OutProfile.Inputs.push_back({item["Name"], item["Offset"], item["Size"]});
+						OutProfile.ProfileName = value.get<std::string>();
+						return true;
 					}
-				}
 
-				if (schema.contains("Outputs"))
-				{
-					for (const auto& item : schema["Outputs"])
+					// --- INPUTS & OUTPUTS ---
+					const std::string& section = path[1].Key;
+					if (section == "Inputs")
 					{
-						OutProfile.Outputs.push_back({item["Name"], item["Offset"], item["Size"]});
+						OutProfile.Inputs.push_back({value["Name"], value["Offset"], value["Size"]});
 					}
-				}
-
-				// --- BINDINGS & RULES ---
-				if (schema.contains("Bindings"))
-				{
-					for (const auto& b : schema["Bindings"])
+					else if (section == "Outputs")
+					{
+						OutProfile.Outputs.push_back({value["Name"], value["Offset"], value["Size"]});
+					}
+					// --- PARAMETERS ---
+					// Parsed once and shared by every rule, instead of copied into each one
+					else if (section == "Parameters")
+					{
+						auto table = ParseParameters(value);
+						table->Id = static_cast<int32_t>(OutProfile.ParameterTables.size());
+						parameters = table;
+						OutProfile.ParameterTables.push_back(parameters);
+					}
+					// --- BINDINGS & RULES ---
+					else if (section == "Bindings")
 					{
 						NRBinding binding;
-						binding.Size = b["Size"];
-						binding.Offset = b["Offset"];
-						binding.BoneName = b["Name"];
-						binding.RuleName = b["Target"];
+						binding.Size = value["Size"];
+						binding.Offset = value["Offset"];
+						binding.BoneName = value["Name"];
+						binding.RuleName = value["Target"];
+						bindings.push_back(std::move(binding));
+					}
+					else
+					{
+						NRRule rule = ParseRule(value);
+						// First definition wins, as the former linear search did
+						rules.emplace(rule.Name, std::move(rule));
+					}
+					return true;
+				});
 
-						if (schema.contains("Rules"))
-						{
-							auto& rules = schema["Rules"];
-							auto it = std::find_if(rules.begin(), rules.end(), [&](const auto& rule) {
-								return rule["Name"] == b["Target"];
-							});
-
-							if (it != rules.end())
-							{
-								NRRule rule;
-								rule.Name = it->at("Name");
-
-								// Parameters (Constants)
-								if (schema.contains("Parameters") && schema["Parameters"].contains("Constants"))
-								{
-									for (auto& el : schema["Parameters"]["Constants"].items())
-									{
-										rule.Constants[el.key()] = el.value().is_number() ? el.value().get<double>() : 0.0;
-									}
-								}
-
-								// Parameters (Variables)
-								if (schema.contains("Parameters") && schema["Parameters"].contains("Variables"))
-								{
-									for (auto& el : schema["Parameters"]["Variables"].items())
-									{
-										NRVars vars;
-										vars.Name = el.key();
-										vars.List = el.value().get<std::vector<std::string>>();
-										rule.Variables.push_back(vars);
-									}
-								}
-
-								// Logic
-								if (it->contains("Logic"))
-								{
-									for (auto& el : it->at("Logic").items())
-									{
-										NRLogic logic;
-										logic.Name = el.key();
-										logic.Expr = el.value();
-										rule.Logic.push_back(logic);
-									}
-								}
-
-								// Rotation Limits
-								if (it->contains("Limits"))
-								{
-									auto& lim = it->at("Limits");
-
-									RotationLimit limits;
-									limits.Min = torch::tensor({
-										DegToRad(lim.value("MinX", -360.0f)),
-										DegToRad(lim.value("MinY", -360.0f)),
-										DegToRad(lim.value("MinZ", -360.0f))
-									});
-									limits.Max = torch::tensor({
-										DegToRad(lim.value("MaxX", 360.0f)),
-										DegToRad(lim.value("MaxY", 360.0f)),
-										DegToRad(lim.value("MaxZ", 360.0f))
-									});
-									rule.Limits = limits;
-								}
-
-								if (it->contains("Phases"))
-								{
-									for (auto& phase_item : it->at("Phases"))
-									{
-										NRRule::Phase phase;
-										phase.Id = phase_item.at("id");
-										phase.Condition = phase_item.at("condition");
-
-										for (auto& el2 : phase_item.items())
-										{
-											if (el2.key() != "condition" && el2.key() != "id")
-											{
-												NRFormula formula;
-												formula.Name = el2.key();
-												formula.Expr = el2.value().get<std::string>();
-												phase.Formulas.push_back(formula);
-											}
-										}
-										rule.Phases.push_back(phase);
-									}
-								}
-								binding.Rules.push_back(rule);
-							}
-						}
-						OutProfile.Bindings.push_back(binding);
+			if (!reader.Read(file))
+			{
+				std::cerr << "JSON IK Error: " << reader.GetError() << std::endl;
+				return false;
+			}
+
+			for (auto& binding : bindings)
+			{
+				auto found = rules.find(binding.RuleName);
+				if (found != rules.end())
+				{
+					NRRule rule = found->second;
+					rule.Parameters = parameters;
+					if (parameters)
+					{
+						binding.ParametersId = parameters->Id;
 					}
+					binding.Rules.push_back(std::move(rule));
 				}
+				OutProfile.Bindings.push_back(std::move(binding));
 			}
 			return true;
 		}
@@ -206,93 +336,36 @@ namespace NR
 
 		try
 		{
-			json j;
-			file >> j;
-			if (!j.contains("Schema")) return false;
-			auto schema = j["Schema"];
-
-			auto parseBone = [&](const json& b) {
-				NRSkeleton::Bone bone;
-				bone.Name = b.value("Name", "");
-				bone.Size = b.value("Size", 0);
-				bone.Offset = b.value("Offset", 0);
-				
-				// Initialize default tensors to avoid "None" tensor errors
-				bone.RestPose.Pos = torch::zeros({3}, torch::kFloat32);
-				bone.RestPose.Rot = torch::tensor({0.0f, 0.0f, 0.0f, 1.0f}, torch::kFloat32);
-				bone.Limits.Min = torch::tensor({-3.14159f, -3.14159f, -3.14159f}, torch::kFloat32);
-				bone.Limits.Max = torch::tensor({3.14159f, 3.14159f, 3.14159f}, torch::kFloat32);
-
-				auto getFloat = [](const json& p, const std::string& key) {
-					auto val = p.value(key, "0.0");
-					std::replace(val.begin(), val.end(), ',', '.');
-					try {
-						return std::stof(val);
-					} catch (...) {
-						return 0.0f;
-					}
-				};
-				if (b.contains("Pose")) {
-					auto& p = b["Pose"];
-
-					bone.RestPose.Pos = torch::tensor({
-						getFloat(p, "x") * 0.01,
-						getFloat(p, "y") * 0.01,
-						getFloat(p, "z") * 0.01
-					});
-
-					if (p.contains("Pitch") || p.contains("Yaw") || p.contains("Roll")) {
-						float pitch = DegToRad(getFloat(p, "Pitch"));
-						float yaw   = DegToRad(getFloat(p, "Yaw"));
-						float roll  = DegToRad(getFloat(p, "Roll"));
-
-						if (OutQuat) {
-							bone.RestPose.Rot = OutQuat->ToQuat(pitch, yaw, roll);
-							std::cout << "Quat: " << pitch << ", " << yaw << ", " << roll << std::endl;
-						} else {
-							std::cerr << "Warning: OutQuat is null, skipping rotation parsing for bone " << bone.Name << std::endl;
-						}
+			bool bSchema = false;
+			JsonRecordReader reader(
+				[&](const JsonRecordReader::Path& path) {
+					bSchema |= JsonRecordReader::Matches(path, {"Schema"});
+					return JsonRecordReader::Matches(path, {"Schema", "Parent"})
+						|| JsonRecordReader::Matches(path, {"Schema", "Rest", "*"});
+				},
+				[&](const JsonRecordReader::Path& path, json&& value) {
+					if (path[1].Key == "Parent")
+					{
+						OutSkeleton.Parent = ParseBone(value, OutQuat);
+						return true;
 					}
-				}
-
-				if (b.contains("Limits")) {
-					auto& lim = b["Limits"];
-
-					RotationLimit limits;
-					limits.Min = torch::tensor({
-						DegToRad(lim.value("MinX", -360.0f)),
-						DegToRad(lim.value("MinY", -360.0f)),
-						DegToRad(lim.value("MinZ", -360.0f))
-					});
-					limits.Max = torch::tensor({
-						DegToRad(lim.value("MaxX", 360.0f)),
-						DegToRad(lim.value("MaxY", 360.0f)),
-						DegToRad(lim.value("MaxZ", 360.0f))
-					});
-
-					bone.Limits = limits;
-				}
-
-				if (b.contains("Childrens")) {
-					bone.ChildrenIndices = b["Childrens"].get<std::vector<int32_t>>();
-				}
-				return bone;
-			};
 
-			if (schema.contains("Parent")) {
-				OutSkeleton.Parent = parseBone(schema["Parent"]);
-			}
-
-			if (schema.contains("Rest")) {
-				for (const auto& chain : schema["Rest"]) {
+					// One chain at a time, chains are short even on full-body rigs
 					std::vector<NRSkeleton::Bone> boneChain;
-					for (const auto& b : chain) {
-						boneChain.push_back(parseBone(b));
+					for (const auto& b : value)
+					{
+						boneChain.push_back(ParseBone(b, OutQuat));
 					}
 					OutSkeleton.Rest.push_back(boneChain);
-				}
+					return true;
+				});
+
+			if (!reader.Read(file))
+			{
+				std::cerr << "JSON SK Error: " << reader.GetError() << std::endl;
+				return false;
 			}
-			return true;
+			return bSchema;
 		}
 		catch (std::exception& e) {
 			std::cerr << "JSON SK Error: " << e.what() << std::endl;
@@ -307,37 +380,43 @@ namespace NR
 
 		try
 		{
-			json j;
-			file >> j;
-			if (!j.contains("Schema")) return false;
-			auto schema = j["Schema"];
-
-			if (schema.contains("HyperParameters")) {
-				auto& hp = schema["HyperParameters"];
-				OutWeights.HyperParameters.LearningRate = hp.value("LearningRate", 0.0001f);
-				OutWeights.HyperParameters.EmaAlpha = hp.value("EmaAlpha", 0.15f);
-				OutWeights.HyperParameters.MaxCandidates = hp.value("MaxCandidates", 5);
-			}
-
-			if (schema.contains("LossWeights")) {
-				for (auto& el : schema["LossWeights"].items()) {
-					NRWeight w;
-					w.Weight = el.value().value("Weight", 1.0f);
-					w.Description = el.value().value("Description", "");
-					OutWeights.LossWeights[el.key()] = w;
-				}
-			}
+			bool bSchema = false;
+			JsonRecordReader reader(
+				[&](const JsonRecordReader::Path& path) {
+					bSchema |= JsonRecordReader::Matches(path, {"Schema"});
+					return JsonRecordReader::Matches(path, {"Schema", "HyperParameters"})
+						|| JsonRecordReader::Matches(path, {"Schema", "LossWeights", "*"})
+						|| JsonRecordReader::Matches(path, {"Schema", "BoneSpecificBias", "*"});
+				},
+				[&](const JsonRecordReader::Path& path, json&& value) {
+					const std::string& section = path[1].Key;
+					if (section == "HyperParameters") {
+						OutWeights.HyperParameters.LearningRate = value.value("LearningRate", 0.0001f);
+						OutWeights.HyperParameters.EmaAlpha = value.value("EmaAlpha", 0.15f);
+						OutWeights.HyperParameters.MaxCandidates = value.value("MaxCandidates", 5);
+					}
+					else if (section == "LossWeights") {
+						NRWeight w;
+						w.Weight = value.value("Weight", 1.0f);
+						w.Description = value.value("Description", "");
+						OutWeights.LossWeights[path[2].Key] = w;
+					}
+					else {
+						NRTrainingWeights::BoneBias bias;
+						bias.Name = value.value("Name", "");
+						bias.PositionMultiplier = value.value("PositionMultiplier", 1.0f);
+						bias.RotationMultiplier = value.value("RotationMultiplier", 1.0f);
+						OutWeights.BoneSpecificBias.push_back(bias);
+					}
+					return true;
+				});
 
-			if (schema.contains("BoneSpecificBias")) {
-				for (const auto& b : schema["BoneSpecificBias"]) {
-					NRTrainingWeights::BoneBias bias;
-					bias.Name = b.value("Name", "");
-					bias.PositionMultiplier = b.value("PositionMultiplier", 1.0f);
-					bias.RotationMultiplier = b.value("RotationMultiplier", 1.0f);
-					OutWeights.BoneSpecificBias.push_back(bias);
-				}
+			if (!reader.Read(file))
+			{
+				std::cerr << "JSON TW Error: " << reader.GetError() << std::endl;
+				return false;
 			}
-			return true;
+			return bSchema;
 		}
 		catch (std::exception& e) {
 			std::cerr << "JSON TW Error: " << e.what() << std::endl;
@@ -0,0 +1,598 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/ProfileCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace NR
+{
+	namespace
+	{
+		constexpr uint64_t FnvOffset = 1469598103934665603ull;
+		constexpr uint64_t FnvPrime = 1099511628211ull;
+
+		// Tensor tags, the rest pose keeps the dtype the JSON loader gave it
+		constexpr uint8_t TensorUndefined = 0;
+		constexpr uint8_t TensorFloat = 1;
+		constexpr uint8_t TensorDouble = 2;
+
+		uint64_t Fnv1a(const char* Data, size_t Size, uint64_t Hash = FnvOffset)
+		{
+			for (size_t i = 0; i < Size; ++i)
+			{
+				Hash ^= static_cast<uint8_t>(Data[i]);
+				Hash *= FnvPrime;
+			}
+			return Hash;
+		}
+
+		class BinaryWriter
+		{
+		public:
+			std::vector<char> Buffer;
+
+			template<typename TValue>
+			void Pod(const TValue& Value)
+			{
+				static_assert(std::is_trivially_copyable_v<TValue>);
+				const auto* bytes = reinterpret_cast<const char*>(&Value);
+				Buffer.insert(Buffer.end(), bytes, bytes + sizeof(TValue));
+			}
+
+			void Count(size_t Value) { Pod(static_cast<uint32_t>(Value)); }
+
+			void String(const std::string& Value)
+			{
+				Count(Value.size());
+				Buffer.insert(Buffer.end(), Value.begin(), Value.end());
+			}
+
+			// Undefined tensors round-trip as undefined, float64 as float64, everything else as float32
+			void Tensor(const torch::Tensor& Value)
+			{
+				if (!Value.defined())
+				{
+					Pod(TensorUndefined);
+					return;
+				}
+
+				const bool bDouble = Value.scalar_type() == torch::kDouble;
+				Pod(bDouble ? TensorDouble : TensorFloat);
+
+				const auto data = Value.detach().to(torch::kCPU, bDouble ? torch::kDouble : torch::kFloat).contiguous();
+				Count(data.dim());
+				for (const auto size : data.sizes())
+				{
+					Pod(static_cast<int64_t>(size));
+				}
+				const auto* bytes = static_cast<const char*>(data.data_ptr());
+				Buffer.insert(Buffer.end(), bytes, bytes + data.numel() * data.element_size());
+			}
+		};
+
+		class BinaryReader
+		{
+		public:
+			BinaryReader(const char* Data, size_t Size)
+				: Data(Data), Size(Size)
+			{
+			}
+
+			bool bOk = true;
+
+			template<typename TValue>
+			TValue Pod()
+			{
+				TValue value{};
+				if (Take(sizeof(TValue)))
+				{
+					std::memcpy(&value, Data + Pos - sizeof(TValue), sizeof(TValue));
+				}
+				return value;
+			}
+
+			uint32_t Count()
+			{
+				const auto value = Pod<uint32_t>();
+				// Every element takes at least one byte, larger counts mean a damaged file
+				if (value > Size - Pos)
+				{
+					bOk = false;
+					return 0;
+				}
+				return value;
+			}
+
+			std::string String()
+			{
+				const uint32_t length = Count();
+				if (!Take(length))
+				{
+					return {};
+				}
+				return {Data + Pos - length, length};
+			}
+
+			torch::Tensor Tensor()
+			{
+				const auto tag = Pod<uint8_t>();
+				if (tag == TensorUndefined)
+				{
+					return {};
+				}
+				if (tag != TensorFloat && tag != TensorDouble)
+				{
+					bOk = false;
+					return {};
+				}
+
+				const auto dtype = tag == TensorDouble ? torch::kDouble : torch::kFloat;
+				const size_t elementSize = tag == TensorDouble ? sizeof(double) : sizeof(float);
+
+				std::vector<int64_t> sizes(Count());
+				int64_t numel = 1;
+				for (auto& size : sizes)
+				{
+					size = Pod<int64_t>();
+					numel *= size;
+				}
+				if (!bOk || numel < 0 || !Take(static_cast<size_t>(numel) * elementSize))
+				{
+					return {};
+				}
+
+				auto* source = const_cast<char*>(Data + Pos - numel * elementSize);
+				return torch::from_blob(source, sizes, dtype).clone();
+			}
+
+		private:
+			const char* Data;
+			size_t Size;
+			size_t Pos = 0;
+
+			bool Take(size_t Bytes)
+			{
+				if (!bOk || Bytes > Size - Pos)
+				{
+					bOk = false;
+					return false;
+				}
+				Pos += Bytes;
+				return true;
+			}
+		};
+
+		void WriteLimit(BinaryWriter& W, const RotationLimit& Limit)
+		{
+			W.Tensor(Limit.Min);
+			W.Tensor(Limit.Max);
+		}
+
+		RotationLimit ReadLimit(BinaryReader& R)
+		{
+			RotationLimit limit;
+			limit.Min = R.Tensor();
+			limit.Max = R.Tensor();
+			return limit;
+		}
+
+		void WriteBlocks(BinaryWriter& W, const std::vector<NRDataBlock>& Blocks)
+		{
+			W.Count(Blocks.size());
+			for (const auto& block : Blocks)
+			{
+				W.String(block.Name);
+				W.Pod(block.Offset);
+				W.Pod(block.FloatCount);
+			}
+		}
+
+		std::vector<NRDataBlock> ReadBlocks(BinaryReader& R)
+		{
+			std::vector<NRDataBlock> blocks(R.Count());
+			for (auto& block : blocks)
+			{
+				block.Name = R.String();
+				block.Offset = R.Pod<int32_t>();
+				block.FloatCount = R.Pod<int32_t>();
+			}
+			return blocks;
+		}
+
+		void WriteParameters(BinaryWriter& W, const NRParameterTable& Table)
+		{
+			W.Count(Table.Constants.size());
+			for (const auto& [name, value] : Table.Constants)
+			{
+				W.String(name);
+				W.Pod(value);
+			}
+
+			W.Count(Table.Variables.size());
+			for (const auto& variable : Table.Variables)
+			{
+				W.String(variable.Name);
+				W.Count(variable.List.size());
+				for (const auto& input : variable.List)
+				{
+					W.String(input);
+				}
+			}
+		}
+
+		std::shared_ptr<const NRParameterTable> ReadParameters(BinaryReader& R, int32_t Id)
+		{
+			auto table = std::make_shared<NRParameterTable>();
+			table->Id = Id;
+
+			for (uint32_t i = 0, n = R.Count(); i < n && R.bOk; ++i)
+			{
+				auto name = R.String();
+				table->Constants[name] = R.Pod<double>();
+			}
+
+			table->Variables.resize(R.Count());
+			for (auto& variable : table->Variables)
+			{
+				variable.Name = R.String();
+				variable.List.resize(R.Count());
+				for (auto& input : variable.List)
+				{
+					input = R.String();
+				}
+			}
+			return table;
+		}
+
+		void WriteRule(BinaryWriter& W, const NRRule& Rule)
+		{
+			W.Tensor(Rule.RestRotationEuler);
+			W.String(Rule.Name);
+			W.Pod(static_cast<int32_t>(Rule.Parameters ? Rule.Parameters->Id : -1));
+
+			W.Count(Rule.Logic.size());
+			for (const auto& logic : Rule.Logic)
+			{
+				W.String(logic.Name);
+				W.String(logic.Expr);
+			}
+
+			WriteLimit(W, Rule.Limits);
+
+			W.Count(Rule.Phases.size());
+			for (const auto& phase : Rule.Phases)
+			{
+				W.String(phase.Id);
+				W.String(phase.Condition);
+				W.Count(phase.Formulas.size());
+				for (const auto& formula : phase.Formulas)
+				{
+					W.String(formula.Name);
+					W.String(formula.Expr);
+				}
+			}
+		}
+
+		NRRule ReadRule(BinaryReader& R, const std::vector<std::shared_ptr<const NRParameterTable>>& Tables)
+		{
+			NRRule rule;
+			rule.RestRotationEuler = R.Tensor();
+			rule.Name = R.String();
+
+			const auto tableId = R.Pod<int32_t>();
+			if (tableId >= 0 && tableId < static_cast<int32_t>(Tables.size()))
+			{
+				rule.Parameters = Tables[tableId];
+			}
+			else if (tableId != -1)
+			{
+				R.bOk = false;
+			}
+
+			rule.Logic.resize(R.Count());
+			for (auto& logic : rule.Logic)
+			{
+				logic.Name = R.String();
+				logic.Expr = R.String();
+			}
+
+			rule.Limits = ReadLimit(R);
+
+			rule.Phases.resize(R.Count());
+			for (auto& phase : rule.Phases)
+			{
+				phase.Id = R.String();
+				phase.Condition = R.String();
+				phase.Formulas.resize(R.Count());
+				for (auto& formula : phase.Formulas)
+				{
+					formula.Name = R.String();
+					formula.Expr = R.String();
+				}
+			}
+			return rule;
+		}
+
+		void WriteBone(BinaryWriter& W, const NRSkeleton::Bone& Bone)
+		{
+			W.String(Bone.Name);
+			W.Pod(Bone.Size);
+			W.Pod(Bone.Offset);
+			W.Tensor(Bone.RestPose.Pos);
+			W.Tensor(Bone.RestPose.Rot);
+			WriteLimit(W, Bone.Limits);
+			W.Count(Bone.ChildrenIndices.size());
+			for (const auto child : Bone.ChildrenIndices)
+			{
+				W.Pod(child);
+			}
+		}
+
+		NRSkeleton::Bone ReadBone(BinaryReader& R)
+		{
+			NRSkeleton::Bone bone;
+			bone.Name = R.String();
+			bone.Size = R.Pod<int32_t>();
+			bone.Offset = R.Pod<int32_t>();
+			bone.RestPose.Pos = R.Tensor();
+			bone.RestPose.Rot = R.Tensor();
+			bone.Limits = ReadLimit(R);
+			bone.ChildrenIndices.resize(R.Count());
+			for (auto& child : bone.ChildrenIndices)
+			{
+				child = R.Pod<int32_t>();
+			}
+			return bone;
+		}
+	} // namespace
+
+	uint64_t ProfileCache::HashFiles(const std::vector<std::string>& Paths, const std::string& Salt)
+	{
+		uint64_t hash = Fnv1a(reinterpret_cast<const char*>(&NRProfileCacheHeader::CurrentVersion), sizeof(uint32_t));
+		hash = Fnv1a(Salt.data(), Salt.size(), hash);
+		for (const auto& path : Paths)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+			{
+				return 0;
+			}
+
+			const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			hash = Fnv1a(contents.data(), contents.size(), hash);
+			hash = Fnv1a("\0", 1, hash); // Separates the files
+		}
+		return hash;
+	}
+
+	bool ProfileCache::Write(const std::string& Path, const NRModelProfile& Profile, uint64_t SourceHash)
+	{
+		BinaryWriter w;
+		w.String(Profile.ProfileName);
+		WriteBlocks(w, Profile.Inputs);
+		WriteBlocks(w, Profile.Outputs);
+
+		w.Count(Profile.ParameterTables.size());
+		for (const auto& table : Profile.ParameterTables)
+		{
+			WriteParameters(w, *table);
+		}
+
+		w.Count(Profile.Bindings.size());
+		for (const auto& binding : Profile.Bindings)
+		{
+			w.String(binding.BoneName);
+			w.String(binding.RuleName);
+			w.Pod(static_cast<int32_t>(binding.Size));
+			w.Pod(static_cast<int32_t>(binding.Offset));
+			w.Pod(static_cast<int32_t>(binding.ParametersId));
+			w.Count(binding.Rules.size());
+			for (const auto& rule : binding.Rules)
+			{
+				WriteRule(w, rule);
+			}
+		}
+
+		WriteBone(w, Profile.Skeleton.Parent);
+		w.Count(Profile.Skeleton.Rest.size());
+		for (const auto& chain : Profile.Skeleton.Rest)
+		{
+			w.Count(chain.size());
+			for (const auto& bone : chain)
+			{
+				WriteBone(w, bone);
+			}
+		}
+
+		const auto& weights = Profile.TrainingWeights;
+		w.Pod(weights.HyperParameters.LearningRate);
+		w.Pod(weights.HyperParameters.EmaAlpha);
+		w.Pod(weights.HyperParameters.MaxCandidates);
+		w.Count(weights.LossWeights.size());
+		for (const auto& [name, weight] : weights.LossWeights)
+		{
+			w.String(name);
+			w.Pod(weight.Weight);
+			w.String(weight.Description);
+		}
+		w.Count(weights.BoneSpecificBias.size());
+		for (const auto& bias : weights.BoneSpecificBias)
+		{
+			w.String(bias.Name);
+			w.Pod(bias.PositionMultiplier);
+			w.Pod(bias.RotationMultiplier);
+		}
+
+		NRProfileCacheHeader header;
+		header.SourceHash = SourceHash;
+		header.PayloadSize = w.Buffer.size();
+		header.PayloadHash = Fnv1a(w.Buffer.data(), w.Buffer.size());
+
+		// Written next to the destination and renamed, readers never see a partial file.
+		// The name is unique per writer, so processes rebuilding the same cache don't share it.
+		std::random_device random;
+#ifdef _WIN32
+		const auto pid = static_cast<int64_t>(_getpid());
+#else
+		const auto pid = static_cast<int64_t>(getpid());
+#endif
+		std::ostringstream suffix;
+		suffix << ".tmp." << pid << '.' << std::hex << random() << random();
+		const std::string temporary = Path + suffix.str();
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				std::cerr << "[ProfileCache] Cannot write " << temporary << std::endl;
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(w.Buffer.data(), static_cast<std::streamsize>(w.Buffer.size()));
+			if (!file.good())
+			{
+				std::cerr << "[ProfileCache] Write failed: " << temporary << std::endl;
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporary, Path, error);
+		if (error)
+		{
+			std::cerr << "[ProfileCache] Cannot replace " << Path << ": " << error.message() << std::endl;
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	bool ProfileCache::Read(const std::string& Path, uint64_t ExpectedHash, NRModelProfile& OutProfile)
+	{
+		std::ifstream file(Path, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+		{
+			return false;
+		}
+
+		const auto fileSize = static_cast<size_t>(file.tellg());
+		NRProfileCacheHeader header;
+		if (fileSize < sizeof(header))
+		{
+			return false;
+		}
+
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (header.Magic == NRProfileCacheHeader::SwappedMagicValue)
+		{
+			std::cerr << "[ProfileCache] Written with the other byte order, rebuilding: " << Path << std::endl;
+			return false;
+		}
+		if (header.Magic != NRProfileCacheHeader::MagicValue || header.Version != NRProfileCacheHeader::CurrentVersion)
+		{
+			return false;
+		}
+		if (header.SourceHash != ExpectedHash || header.PayloadSize != fileSize - sizeof(header))
+		{
+			return false;
+		}
+
+		std::vector<char> payload(header.PayloadSize);
+		file.read(payload.data(), static_cast<std::streamsize>(payload.size()));
+		if (!file.good() || Fnv1a(payload.data(), payload.size()) != header.PayloadHash)
+		{
+			std::cerr << "[ProfileCache] Damaged cache: " << Path << std::endl;
+			return false;
+		}
+
+		BinaryReader r(payload.data(), payload.size());
+		NRModelProfile profile;
+		profile.ProfileName = r.String();
+		profile.Inputs = ReadBlocks(r);
+		profile.Outputs = ReadBlocks(r);
+
+		profile.ParameterTables.resize(r.Count());
+		for (size_t i = 0; i < profile.ParameterTables.size() && r.bOk; ++i)
+		{
+			profile.ParameterTables[i] = ReadParameters(r, static_cast<int32_t>(i));
+		}
+
+		profile.Bindings.resize(r.Count());
+		for (auto& binding : profile.Bindings)
+		{
+			binding.BoneName = r.String();
+			binding.RuleName = r.String();
+			binding.Size = r.Pod<int32_t>();
+			binding.Offset = r.Pod<int32_t>();
+			binding.ParametersId = r.Pod<int32_t>();
+			binding.Rules.resize(r.Count());
+			for (auto& rule : binding.Rules)
+			{
+				rule = ReadRule(r, profile.ParameterTables);
+			}
+		}
+
+		profile.Skeleton.Parent = ReadBone(r);
+		profile.Skeleton.Rest.resize(r.Count());
+		for (auto& chain : profile.Skeleton.Rest)
+		{
+			chain.resize(r.Count());
+			for (auto& bone : chain)
+			{
+				bone = ReadBone(r);
+			}
+		}
+
+		auto& weights = profile.TrainingWeights;
+		weights.HyperParameters.LearningRate = r.Pod<float>();
+		weights.HyperParameters.EmaAlpha = r.Pod<float>();
+		weights.HyperParameters.MaxCandidates = r.Pod<int32_t>();
+		for (uint32_t i = 0, n = r.Count(); i < n && r.bOk; ++i)
+		{
+			auto name = r.String();
+			NRWeight weight;
+			weight.Weight = r.Pod<float>();
+			weight.Description = r.String();
+			weights.LossWeights[name] = weight;
+		}
+		weights.BoneSpecificBias.resize(r.Count());
+		for (auto& bias : weights.BoneSpecificBias)
+		{
+			bias.Name = r.String();
+			bias.PositionMultiplier = r.Pod<float>();
+			bias.RotationMultiplier = r.Pod<float>();
+		}
+
+		if (!r.bOk)
+		{
+			std::cerr << "[ProfileCache] Malformed cache: " << Path << std::endl;
+			return false;
+		}
+
+		OutProfile = std::move(profile);
+		return true;
+	}
+} // namespace NR
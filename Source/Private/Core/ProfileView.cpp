@@ -0,0 +1,64 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/ProfileView.h"
+
+namespace NR
+{
+	NRProfileView::NRProfileView(const NRModelProfile& Profile)
+		: Inputs(Profile.Inputs)
+		, Outputs(Profile.Outputs)
+		, InputSize(Profile.GetRequiredInputSize())
+		, OutputSize(Profile.GetRequiredOutputSize())
+	{
+		// First block wins on duplicate names, as the linear lookups on the profile do
+		for (size_t i = 0; i < Inputs.size(); ++i)
+		{
+			InputIndex.emplace(Inputs[i].Name, static_cast<int32_t>(i));
+		}
+		for (size_t i = 0; i < Outputs.size(); ++i)
+		{
+			OutputIndex.emplace(Outputs[i].Name, static_cast<int32_t>(i));
+		}
+	}
+
+	NRInputHandle NRProfileView::FindInput(const std::string& Name) const
+	{
+		auto found = InputIndex.find(Name);
+		return found != InputIndex.end() ? NRInputHandle{found->second} : NRInputHandle{};
+	}
+
+	NROutputHandle NRProfileView::FindOutput(const std::string& Name) const
+	{
+		auto found = OutputIndex.find(Name);
+		return found != OutputIndex.end() ? NROutputHandle{found->second} : NROutputHandle{};
+	}
+
+	torch::Tensor NRProfileView::Slice(const torch::Tensor& Input, NRInputHandle Handle) const
+	{
+		return Handle.IsValid() ? SliceBlock(Input, Inputs[Handle.Index]) : torch::Tensor();
+	}
+
+	torch::Tensor NRProfileView::Slice(const torch::Tensor& Output, NROutputHandle Handle) const
+	{
+		return Handle.IsValid() ? SliceBlock(Output, Outputs[Handle.Index]) : torch::Tensor();
+	}
+
+	torch::Tensor NRProfileView::SliceBlock(const torch::Tensor& Data, const NRDataBlock& Block)
+	{
+		const int64_t dim = Data.dim() > 1 ? 1 : 0;
+		return Data.slice(dim, Block.Offset, Block.Offset + Block.FloatCount);
+	}
+} // namespace NR
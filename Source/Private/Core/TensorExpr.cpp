@@ -0,0 +1,507 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/TensorExpr.h"
+#include <cctype>
+#include <cmath>
+#include <unordered_set>
+
+namespace NR
+{
+	namespace
+	{
+		enum class TokenKind : uint8_t
+		{
+			Number,
+			Identifier,
+			Operator,
+			End
+		};
+
+		struct Token
+		{
+			TokenKind Kind = TokenKind::End;
+			std::string Text;
+			double Value = 0.0;
+		};
+
+		// Binding power of binary operators, muParser order: every comparison shares one
+		// level and ^ binds tighter than unary minus
+		int BinaryPower(const std::string& Op)
+		{
+			if (Op == "||") return 1;
+			if (Op == "&&") return 2;
+			if (Op == "==" || Op == "!=" || Op == "<" || Op == ">" || Op == "<=" || Op == ">=") return 4;
+			if (Op == "+" || Op == "-") return 5;
+			if (Op == "*" || Op == "/") return 6;
+			if (Op == "^") return 8;
+			return -1;
+		}
+
+		constexpr int UnaryPower = 7;
+
+		// Arity of the supported functions, -1 for variadic
+		int FunctionArity(const std::string& Name)
+		{
+			static const std::unordered_map<std::string, int> arity = {
+				{"sin", 1}, {"cos", 1}, {"tan", 1}, {"asin", 1}, {"acos", 1}, {"atan", 1},
+				{"sinh", 1}, {"cosh", 1}, {"tanh", 1}, {"asinh", 1}, {"acosh", 1}, {"atanh", 1},
+				{"log2", 1}, {"log10", 1}, {"log", 1}, {"ln", 1}, {"exp", 1}, {"sqrt", 1},
+				{"sign", 1}, {"rint", 1}, {"abs", 1},
+				{"min", -1}, {"max", -1}, {"sum", -1}, {"avg", -1},
+				{"fmod", 2}, {"pow", 2}, {"clamp", 3},
+			};
+
+			auto it = arity.find(Name);
+			return it != arity.end() ? it->second : 0;
+		}
+	} // namespace
+
+	class TensorExpr::Parser
+	{
+	public:
+		Parser(TensorExpr& Target, const Resolver& Resolve)
+			: Target(Target), Resolve(Resolve), Text(Target.Source)
+		{
+		}
+
+		bool Run()
+		{
+			Next();
+			const int32_t root = ParseExpression(0);
+			if (root < 0)
+			{
+				return false;
+			}
+			if (Current.Kind != TokenKind::End)
+			{
+				return Fail("Unexpected token '" + Current.Text + "'");
+			}
+
+			Target.Root = root;
+			return true;
+		}
+
+	private:
+		TensorExpr& Target;
+		const Resolver& Resolve;
+		const std::string& Text;
+		size_t Pos = 0;
+		Token Current;
+
+		bool Fail(const std::string& Message)
+		{
+			if (Target.Error.empty())
+			{
+				Target.Error = Message + " at position " + std::to_string(Pos);
+			}
+			return false;
+		}
+
+		int32_t AddNode(Node&& N)
+		{
+			Target.Nodes.push_back(std::move(N));
+			return static_cast<int32_t>(Target.Nodes.size() - 1);
+		}
+
+		void Next()
+		{
+			while (Pos < Text.size() && std::isspace(static_cast<unsigned char>(Text[Pos])))
+			{
+				++Pos;
+			}
+
+			Current = Token{};
+			if (Pos >= Text.size())
+			{
+				return;
+			}
+
+			const char c = Text[Pos];
+			if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && Pos + 1 < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Pos + 1]))))
+			{
+				size_t consumed = 0;
+				Current.Kind = TokenKind::Number;
+				Current.Value = std::stod(Text.substr(Pos), &consumed);
+				Current.Text = Text.substr(Pos, consumed);
+				Pos += consumed;
+				return;
+			}
+
+			if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+			{
+				const size_t start = Pos;
+				while (Pos < Text.size() && (std::isalnum(static_cast<unsigned char>(Text[Pos])) || Text[Pos] == '_'))
+				{
+					++Pos;
+				}
+				Current.Kind = TokenKind::Identifier;
+				Current.Text = Text.substr(start, Pos - start);
+				return;
+			}
+
+			static const char* twoChar[] = {"<=", ">=", "==", "!=", "&&", "||"};
+			for (const char* op : twoChar)
+			{
+				if (Text.compare(Pos, 2, op) == 0)
+				{
+					Current.Kind = TokenKind::Operator;
+					Current.Text = op;
+					Pos += 2;
+					return;
+				}
+			}
+
+			Current.Kind = TokenKind::Operator;
+			Current.Text = std::string(1, c);
+			++Pos;
+		}
+
+		bool Expect(const char* Op)
+		{
+			if (Current.Kind != TokenKind::Operator || Current.Text != Op)
+			{
+				return Fail(std::string("Expected '") + Op + "'");
+			}
+			Next();
+			return true;
+		}
+
+		int32_t ParseExpression(int MinPower)
+		{
+			int32_t left = ParsePrefix();
+			if (left < 0)
+			{
+				return -1;
+			}
+
+			while (Current.Kind == TokenKind::Operator)
+			{
+				const std::string op = Current.Text;
+
+				// Ternary is the loosest operator and right associative
+				if (op == "?")
+				{
+					if (MinPower > 0)
+					{
+						break;
+					}
+					Next();
+					const int32_t whenTrue = ParseExpression(0);
+					if (whenTrue < 0 || !Expect(":"))
+					{
+						return -1;
+					}
+					const int32_t whenFalse = ParseExpression(0);
+					if (whenFalse < 0)
+					{
+						return -1;
+					}
+
+					Node n;
+					n.Kind = NodeKind::Ternary;
+					n.Args = {left, whenTrue, whenFalse};
+					left = AddNode(std::move(n));
+					continue;
+				}
+
+				const int power = BinaryPower(op);
+				if (power < 0 || power <= MinPower)
+				{
+					break;
+				}
+
+				Next();
+				// ^ is right associative, everything else left associative
+				const int32_t right = ParseExpression(op == "^" ? power - 1 : power);
+				if (right < 0)
+				{
+					return -1;
+				}
+
+				Node n;
+				n.Kind = NodeKind::Binary;
+				n.Op = op;
+				n.Args = {left, right};
+				left = AddNode(std::move(n));
+			}
+
+			return left;
+		}
+
+		int32_t ParsePrefix()
+		{
+			if (Current.Kind == TokenKind::Number)
+			{
+				Node n;
+				n.Kind = NodeKind::Constant;
+				n.Value = Current.Value;
+				Next();
+				return AddNode(std::move(n));
+			}
+
+			if (Current.Kind == TokenKind::Identifier)
+			{
+				const std::string name = Current.Text;
+				Next();
+
+				if (Current.Kind == TokenKind::Operator && Current.Text == "(")
+				{
+					return ParseCall(name);
+				}
+
+				if (name == "_pi" || name == "_e")
+				{
+					Node n;
+					n.Kind = NodeKind::Constant;
+					n.Value = name == "_pi" ? 3.1415926535 : 2.718281828459045;
+					return AddNode(std::move(n));
+				}
+
+				const int32_t slot = Resolve(name);
+				if (slot < 0)
+				{
+					Fail("Unknown variable '" + name + "'");
+					return -1;
+				}
+
+				Node n;
+				n.Kind = NodeKind::Variable;
+				n.Slot = slot;
+				return AddNode(std::move(n));
+			}
+
+			if (Current.Kind == TokenKind::Operator)
+			{
+				const std::string op = Current.Text;
+				if (op == "(")
+				{
+					Next();
+					const int32_t inner = ParseExpression(0);
+					if (inner < 0 || !Expect(")"))
+					{
+						return -1;
+					}
+					return inner;
+				}
+
+				if (op == "-" || op == "+" || op == "!")
+				{
+					Next();
+					const int32_t operand = ParseExpression(UnaryPower);
+					if (operand < 0)
+					{
+						return -1;
+					}
+					if (op == "+")
+					{
+						return operand;
+					}
+
+					Node n;
+					n.Kind = NodeKind::Unary;
+					n.Op = op;
+					n.Args = {operand};
+					return AddNode(std::move(n));
+				}
+			}
+
+			Fail(Current.Kind == TokenKind::End ? "Unexpected end of expression" : "Unexpected token '" + Current.Text + "'");
+			return -1;
+		}
+
+		int32_t ParseCall(const std::string& Name)
+		{
+			const int arity = FunctionArity(Name);
+			if (arity == 0)
+			{
+				Fail("Unknown function '" + Name + "'");
+				return -1;
+			}
+
+			Next(); // (
+			Node n;
+			n.Kind = NodeKind::Call;
+			n.Op = Name;
+
+			if (!(Current.Kind == TokenKind::Operator && Current.Text == ")"))
+			{
+				while (true)
+				{
+					const int32_t arg = ParseExpression(0);
+					if (arg < 0)
+					{
+						return -1;
+					}
+					n.Args.push_back(arg);
+
+					if (Current.Kind == TokenKind::Operator && Current.Text == ",")
+					{
+						Next();
+						continue;
+					}
+					break;
+				}
+			}
+
+			if (!Expect(")"))
+			{
+				return -1;
+			}
+
+			if ((arity > 0 && static_cast<int>(n.Args.size()) != arity) || n.Args.empty())
+			{
+				Fail("Wrong number of arguments for '" + Name + "'");
+				return -1;
+			}
+
+			return AddNode(std::move(n));
+		}
+	};
+
+	bool TensorExpr::Compile(const std::string& Expression, const Resolver& Resolve)
+	{
+		Source = Expression;
+		Error.clear();
+		Nodes.clear();
+		Root = -1;
+
+		Parser parser(*this, Resolve);
+		if (!parser.Run())
+		{
+			Nodes.clear();
+			Root = -1;
+			std::cerr << "Error compiling tensor expression [" << Expression << "]: " << Error << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<int32_t> TensorExpr::UsedVars() const
+	{
+		std::vector<int32_t> used;
+		std::unordered_set<int32_t> seen;
+		for (const auto& n : Nodes)
+		{
+			if (n.Kind == NodeKind::Variable && seen.insert(n.Slot).second)
+			{
+				used.push_back(n.Slot);
+			}
+		}
+		return used;
+	}
+
+	torch::Tensor TensorExpr::Eval(const std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const
+	{
+		if (Root < 0)
+		{
+			return torch::zeros({}, Options);
+		}
+		return EvalNode(Root, Vars, Options);
+	}
+
+	torch::Tensor TensorExpr::EvalNode(int32_t Index, const std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const
+	{
+		const Node& n = Nodes[Index];
+		auto arg = [&](size_t i) { return EvalNode(n.Args[i], Vars, Options); };
+		// Booleans go back to the value dtype, muParser yields 0/1
+		auto toValue = [&](const torch::Tensor& t) { return t.to(Options.dtype().toScalarType()); };
+		auto truthy = [](const torch::Tensor& t) { return t != 0; };
+
+		switch (n.Kind)
+		{
+			case NodeKind::Constant:
+				return torch::scalar_tensor(n.Value, Options);
+
+			case NodeKind::Variable:
+				return Vars[n.Slot];
+
+			case NodeKind::Unary:
+				if (n.Op == "-")
+				{
+					return -arg(0);
+				}
+				return toValue(torch::logical_not(truthy(arg(0))));
+
+			case NodeKind::Ternary:
+				return torch::where(truthy(arg(0)), arg(1), arg(2));
+
+			case NodeKind::Binary:
+			{
+				const auto a = arg(0);
+				const auto b = arg(1);
+				const std::string& op = n.Op;
+				if (op == "+") return a + b;
+				if (op == "-") return a - b;
+				if (op == "*") return a * b;
+				if (op == "/") return a / b;
+				if (op == "^") return torch::pow(a, b);
+				if (op == "<") return toValue(a < b);
+				if (op == ">") return toValue(a > b);
+				if (op == "<=") return toValue(a <= b);
+				if (op == ">=") return toValue(a >= b);
+				if (op == "==") return toValue(a == b);
+				if (op == "!=") return toValue(a != b);
+				if (op == "&&") return toValue(torch::logical_and(truthy(a), truthy(b)));
+				if (op == "||") return toValue(torch::logical_or(truthy(a), truthy(b)));
+				break;
+			}
+
+			case NodeKind::Call:
+			{
+				const std::string& fn = n.Op;
+				if (fn == "sin") return torch::sin(arg(0));
+				if (fn == "cos") return torch::cos(arg(0));
+				if (fn == "tan") return torch::tan(arg(0));
+				if (fn == "asin") return torch::asin(arg(0));
+				if (fn == "acos") return torch::acos(arg(0));
+				if (fn == "atan") return torch::atan(arg(0));
+				if (fn == "sinh") return torch::sinh(arg(0));
+				if (fn == "cosh") return torch::cosh(arg(0));
+				if (fn == "tanh") return torch::tanh(arg(0));
+				if (fn == "asinh") return torch::asinh(arg(0));
+				if (fn == "acosh") return torch::acosh(arg(0));
+				if (fn == "atanh") return torch::atanh(arg(0));
+				if (fn == "log2") return torch::log2(arg(0));
+				if (fn == "log10") return torch::log10(arg(0));
+				if (fn == "log" || fn == "ln") return torch::log(arg(0));
+				if (fn == "exp") return torch::exp(arg(0));
+				if (fn == "sqrt") return torch::sqrt(arg(0));
+				if (fn == "sign") return torch::sign(arg(0));
+				if (fn == "rint") return torch::round(arg(0));
+				if (fn == "abs") return torch::abs(arg(0));
+				if (fn == "fmod") return torch::fmod(arg(0), arg(1));
+				if (fn == "pow") return torch::pow(arg(0), arg(1));
+				if (fn == "clamp") return torch::clamp(arg(0), arg(1), arg(2));
+
+				auto result = arg(0);
+				for (size_t i = 1; i < n.Args.size(); ++i)
+				{
+					const auto next = arg(i);
+					if (fn == "min") result = torch::minimum(result, next);
+					else if (fn == "max") result = torch::maximum(result, next);
+					else result = result + next;
+				}
+				if (fn == "avg")
+				{
+					result = result / static_cast<double>(n.Args.size());
+				}
+				return result;
+			}
+		}
+
+		return torch::zeros({}, Options);
+	}
+} // namespace NR
@@ -0,0 +1,305 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/TensorRules.h"
+
+namespace NR
+{
+	namespace
+	{
+		int64_t FindInputOffset(const NRModelProfile& Profile, const std::string& Name)
+		{
+			for (const auto& block : Profile.Inputs)
+			{
+				if (block.Name == Name)
+				{
+					return block.Offset;
+				}
+			}
+			return -1;
+		}
+	} // namespace
+
+	TensorRules::TensorRules(Rules& Source, const NRModelProfile& Profile)
+		: Source(Source)
+	{
+		TCycleInput = FindInputOffset(Profile, "t_cycle");
+
+		const int numBindings = static_cast<int>(std::min(Source.CompiledRules.size(), Profile.Bindings.size()));
+		Bindings.resize(numBindings);
+
+		for (int b = 0; b < numBindings; ++b)
+		{
+			BindingState& state = Bindings[b];
+			state.Offset = Profile.Bindings[b].Offset;
+
+			std::unordered_map<std::string, int32_t> slotOf;
+			std::unordered_map<const double*, int32_t> slotOfPtr;
+			for (auto& [name, value] : Source.Vars[b])
+			{
+				slotOf[name] = static_cast<int32_t>(state.Scalars.size());
+				slotOfPtr[&value] = slotOf[name];
+				state.Scalars.push_back(&value);
+			}
+
+			const TensorExpr::Resolver resolve = [&slotOf](const std::string& name) {
+				auto it = slotOf.find(name);
+				return it != slotOf.end() ? it->second : -1;
+			};
+			auto lower = [&](const std::string& expression) {
+				TensorExpr expr;
+				bValid &= expr.Compile(expression, resolve);
+				return expr;
+			};
+
+			for (auto& compiled : Source.CompiledRules[b])
+			{
+				if (compiled.Logic.empty())
+				{
+					continue;
+				}
+
+				const auto& rule = compiled.Source;
+				const double* tGaitSlot = Source.GetTGaitSlot(compiled, b);
+				for (const auto& input : Source.GetInputs(compiled, b, Profile))
+				{
+					const int32_t slot = slotOfPtr.at(input.Slot);
+					if (input.bClock)
+					{
+						BindingState::ClockRead read;
+						read.Slot = slot;
+						if (tGaitSlot)
+						{
+							read.TGait = compiled.TGait;
+							read.TGaitSlot = slotOfPtr.at(tGaitSlot);
+						}
+						state.ClockReads.push_back(read);
+						continue;
+					}
+					state.InputSlots.emplace_back(slot, input.Offset);
+				}
+
+				RuleProgram& program = state.Programs.emplace_back();
+				// Dependency order, as sorted by Rules
+				for (const auto& [slot, handle] : compiled.Logic)
+				{
+					program.Logic.emplace_back(slotOfPtr[slot], lower(Source.GetSource(handle)));
+				}
+				for (const auto& phase : rule.Phases)
+				{
+					RuleProgram::Phase& lowered = program.Phases.emplace_back();
+					lowered.Condition = lower(phase.Condition);
+					for (const auto& [_formulaName, expr] : phase.Formulas)
+					{
+						lowered.Formulas.push_back(lower(expr));
+					}
+				}
+			}
+		}
+	}
+
+	void TensorRules::RunLogic(const RuleProgram& Program, std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const
+	{
+		for (const auto& [slot, expr] : Program.Logic)
+		{
+			Vars[slot] = expr.Eval(Vars, Options);
+		}
+	}
+
+	torch::Tensor TensorRules::Evaluate(const torch::Tensor& Inputs, int64_t OutCount)
+	{
+		auto rows2D = Inputs.reshape({Inputs.dim() > 1 ? Inputs.size(0) : 1, -1});
+		if (!rows2D.is_floating_point())
+		{
+			rows2D = rows2D.to(torch::kFloat);
+		}
+
+		const int64_t rows = rows2D.size(0);
+		const auto options = rows2D.options();
+		if (rows == 0 || !bValid)
+		{
+			return torch::zeros({rows, OutCount}, options.dtype(torch::kFloat));
+		}
+
+		// 1. Slots start from the scalar state (constants, phase variables), inputs are columns
+		std::vector<std::vector<torch::Tensor>> vars(Bindings.size());
+		for (size_t b = 0; b < Bindings.size(); ++b)
+		{
+			const auto& state = Bindings[b];
+			vars[b].resize(state.Scalars.size());
+			for (size_t s = 0; s < state.Scalars.size(); ++s)
+			{
+				vars[b][s] = torch::scalar_tensor(*state.Scalars[s], options);
+			}
+			for (const auto& [slot, offset] : state.InputSlots)
+			{
+				vars[b][slot] = rows2D.select(1, offset);
+			}
+		}
+
+		// 2. Logic once to know T_gait on every row, t_cycle is still the previous value here
+		std::vector<torch::Tensor> clockColumns;
+		if (TCycleInput >= 0)
+		{
+			clockColumns.push_back(rows2D.select(1, TCycleInput));
+		}
+		for (size_t b = 0; b < Bindings.size(); ++b)
+		{
+			const auto& state = Bindings[b];
+			const bool bNeedsTGait = std::any_of(state.ClockReads.begin(), state.ClockReads.end(), [](const auto& read) {
+				return read.TGait != InvalidExpr;
+			});
+			if (!bNeedsTGait)
+			{
+				continue;
+			}
+
+			auto scratch = vars[b];
+			for (const auto& program : state.Programs)
+			{
+				RunLogic(program, scratch, options);
+			}
+			for (const auto& read : state.ClockReads)
+			{
+				if (read.TGait != InvalidExpr)
+				{
+					clockColumns.push_back(scratch[read.TGaitSlot].expand({rows}));
+				}
+			}
+		}
+
+		// 3. Gait clock, sequential across rows and shared by every binding, one transfer each way
+		if (!clockColumns.empty())
+		{
+			const auto host = torch::stack(clockColumns).detach().to(torch::kCPU, torch::kDouble).contiguous();
+			const double* hostData = host.data_ptr<double>();
+			const double* tCycle = TCycleInput >= 0 ? hostData : nullptr;
+			const double* tGait = hostData + (TCycleInput >= 0 ? rows : 0);
+
+			std::vector<std::vector<double>> clock;
+			for (const auto& state : Bindings)
+			{
+				for (const auto& read : state.ClockReads)
+				{
+					if (read.TGait != InvalidExpr)
+					{
+						clock.emplace_back(rows);
+					}
+				}
+			}
+
+			double& deltaTime = Source.deltaTime;
+			for (int64_t r = 0; r < rows; ++r)
+			{
+				size_t written = 0;
+				for (const auto& state : Bindings)
+				{
+					for (const auto& read : state.ClockReads)
+					{
+						deltaTime += tCycle ? tCycle[r] : 0.0;
+						if (read.TGait == InvalidExpr)
+						{
+							continue;
+						}
+
+						const double T_gait = r == 0 ? Source.Eval(read.TGait) : tGait[written * rows + r - 1];
+						if (T_gait > 0.0)
+						{
+							deltaTime = std::fmod(deltaTime, T_gait);
+						}
+						clock[written++][r] = deltaTime;
+					}
+				}
+			}
+
+			size_t written = 0;
+			for (size_t b = 0; b < Bindings.size(); ++b)
+			{
+				for (const auto& read : Bindings[b].ClockReads)
+				{
+					if (read.TGait != InvalidExpr)
+					{
+						vars[b][read.Slot] = torch::from_blob(clock[written++].data(), {rows}, torch::kDouble).to(options, false, true);
+					}
+				}
+			}
+		}
+
+		// 4. Logic, conditions and formulas over the batch, phases picked with a mask
+		std::vector<torch::Tensor> columns(OutCount);
+		for (size_t b = 0; b < Bindings.size(); ++b)
+		{
+			const auto& state = Bindings[b];
+			for (const auto& program : state.Programs)
+			{
+				RunLogic(program, vars[b], options);
+
+				auto taken = torch::zeros({rows}, options.dtype(torch::kBool));
+				for (const auto& phase : program.Phases)
+				{
+					const auto take = (phase.Condition.Eval(vars[b], options) != 0).expand({rows}).logical_and(taken.logical_not());
+					taken = taken.logical_or(take);
+
+					for (size_t f = 0; f < phase.Formulas.size(); ++f)
+					{
+						const int64_t column = state.Offset + static_cast<int64_t>(f);
+						if (column >= OutCount)
+						{
+							break;
+						}
+
+						const auto value = phase.Formulas[f].Eval(vars[b], options).expand({rows});
+						const auto previous = columns[column].defined() ? columns[column] : torch::zeros({rows}, options);
+						columns[column] = torch::where(take, value, previous);
+					}
+				}
+			}
+		}
+
+		for (auto& column : columns)
+		{
+			if (!column.defined())
+			{
+				column = torch::zeros({rows}, options);
+			}
+		}
+
+		// 5. Scalar state continues from the last row
+		std::vector<torch::Tensor> last;
+		for (const auto& slots : vars)
+		{
+			for (const auto& value : slots)
+			{
+				last.push_back(value.detach().expand({rows})[rows - 1]);
+			}
+		}
+		if (!last.empty())
+		{
+			const auto host = torch::stack(last).to(torch::kCPU, torch::kDouble).contiguous();
+			const double* hostData = host.data_ptr<double>();
+			size_t i = 0;
+			for (const auto& state : Bindings)
+			{
+				for (double* scalar : state.Scalars)
+				{
+					*scalar = hostData[i++];
+				}
+			}
+		}
+
+		// Evaluated in the input dtype, returned as float like the muParser targets
+		return OutCount > 0 ? torch::stack(columns, 1).to(torch::kFloat) : torch::zeros({rows, 0}, options.dtype(torch::kFloat));
+	}
+} // namespace NR
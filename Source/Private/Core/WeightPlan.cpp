@@ -0,0 +1,64 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Core/WeightPlan.h"
+
+namespace NR
+{
+	const char* NRWeightPlan::SlotName(NRLossSlot Slot)
+	{
+		switch (Slot)
+		{
+			case NRLossSlot::Objective: return "Objective";
+			case NRLossSlot::Position: return "Position";
+			case NRLossSlot::Kinematics: return "Kinematics";
+			case NRLossSlot::Temporal: return "Temporal";
+			case NRLossSlot::Acceleration: return "Acceleration";
+			case NRLossSlot::SmoothOutput: return "SmoothOutput";
+			case NRLossSlot::QuaternionNorm: return "QuaternionNorm";
+			default: return "";
+		}
+	}
+
+	NRWeightPlan NRWeightPlan::Compile(const NRTrainingWeights& Weights, const NRKinematicLayout& Layout)
+	{
+		NRWeightPlan plan;
+		for (size_t i = 0; i < plan.Loss.size(); ++i)
+		{
+			auto it = Weights.LossWeights.find(SlotName(static_cast<NRLossSlot>(i)));
+			plan.Loss[i] = (it != Weights.LossWeights.end()) ? it->second.Weight : 1.0f;
+		}
+
+		const int64_t numBones = Layout.NumBones();
+		std::vector<float> position(numBones, 1.0f);
+		std::vector<float> rotation(numBones, 1.0f);
+		for (int64_t i = 0; i < numBones; ++i)
+		{
+			for (const auto& bias : Weights.BoneSpecificBias)
+			{
+				if (bias.Name == Layout.Names[i])
+				{
+					position[i] = bias.PositionMultiplier;
+					rotation[i] = bias.RotationMultiplier;
+					break;
+				}
+			}
+		}
+
+		plan.BonePosition = torch::tensor(position);
+		plan.BoneRotation = torch::tensor(rotation);
+		return plan;
+	}
+} // namespace NR
@@ -0,0 +1,212 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Solver/ProfileRegistry.h"
+#include "Core/Parse.h"
+#include <algorithm>
+#include <iostream>
+
+namespace NR
+{
+	ProfileRegistry::ProfileRegistry(ModelFactory InFactory, torch::Device InDevice)
+		: Factory(std::move(InFactory))
+		, Device(InDevice)
+	{
+	}
+
+	int32_t ProfileRegistry::Register(const std::string& Id, NRModelProfile Profile, const Rules& Base)
+	{
+		auto entry = std::make_unique<NRRegisteredProfile>();
+		entry->Id = Id;
+		entry->Compiled = NRCompiledProfile::Compile(std::move(Profile), Base);
+		entry->Topology = TopologyKey(entry->Compiled);
+
+		const std::string& topology = entry->Topology;
+		auto model = Models.find(topology);
+		if (model == Models.end())
+		{
+			auto created = Factory ? Factory(entry->Compiled.Profile) : nullptr;
+			if (!created)
+			{
+				std::cerr << "[ProfileRegistry] No model for profile " << Id << std::endl;
+				return -1;
+			}
+			model = Models.emplace(topology, std::move(created)).first;
+		}
+
+		entry->Model = model->second;
+		entry->ProfileSolver = std::make_unique<Solver>(entry->Model, entry->Compiled.Profile, Device);
+
+		// Re-registering keeps the handle, so frames already addressed to it stay valid
+		auto handle = Handles.find(Id);
+		if (handle != Handles.end())
+		{
+			const std::string previous = Entries[handle->second]->Topology;
+			Entries[handle->second] = std::move(entry);
+
+			const bool bUsed = std::any_of(Entries.begin(), Entries.end(), [&](const auto& other) {
+				return other->Topology == previous;
+			});
+			if (!bUsed)
+			{
+				Models.erase(previous);
+			}
+			return handle->second;
+		}
+
+		const auto index = static_cast<int32_t>(Entries.size());
+		Entries.push_back(std::move(entry));
+		Handles.emplace(Id, index);
+		return index;
+	}
+
+	int32_t ProfileRegistry::Load(const std::string& Id, const std::string& IKPath, const std::string& SKPath, const std::string& TWPath,
+	                              IQuat* Quat, const std::string& CachePath)
+	{
+		NRModelProfile profile;
+		bool bLoaded;
+		if (!CachePath.empty())
+		{
+			bLoaded = Parse::LoadProfileCached(IKPath, SKPath, TWPath, CachePath, profile, Quat);
+		}
+		else
+		{
+			bLoaded = Parse::LoadIKFromJson(IKPath, profile)
+				&& Parse::LoadSKFromJson(SKPath, profile.Skeleton, Quat)
+				&& Parse::LoadTWFromJson(TWPath, profile.TrainingWeights);
+		}
+
+		if (!bLoaded)
+		{
+			std::cerr << "[ProfileRegistry] Failed to load profile " << Id << ": " << IKPath << std::endl;
+			return -1;
+		}
+		return Register(Id, std::move(profile));
+	}
+
+	int32_t ProfileRegistry::Find(const std::string& Id) const
+	{
+		auto handle = Handles.find(Id);
+		return handle != Handles.end() ? handle->second : -1;
+	}
+
+	const NRRegisteredProfile* ProfileRegistry::Get(int32_t Handle) const
+	{
+		if (Handle < 0 || Handle >= static_cast<int32_t>(Entries.size()))
+		{
+			return nullptr;
+		}
+		return Entries[Handle].get();
+	}
+
+	std::vector<float> ProfileRegistry::Solve(int32_t Handle, const std::vector<float>& Input)
+	{
+		const NRRegisteredProfile* entry = Get(Handle);
+		if (!entry)
+		{
+			return {};
+		}
+
+		const size_t inCount = entry->ProfileSolver->GetView().GetInputSize();
+		if (inCount == 0 || Input.size() < inCount)
+		{
+			return {};
+		}
+		return entry->ProfileSolver->Solve(Input);
+	}
+
+	std::vector<std::vector<float>> ProfileRegistry::Solve(const std::vector<NRProfileFrame>& Frames)
+	{
+		std::vector<std::vector<float>> results(Frames.size());
+
+		std::vector<std::vector<size_t>> groups(Entries.size());
+		for (size_t i = 0; i < Frames.size(); ++i)
+		{
+			if (Get(Frames[i].Profile))
+			{
+				groups[Frames[i].Profile].push_back(i);
+			}
+		}
+
+		std::vector<float> batch;
+		for (size_t handle = 0; handle < groups.size(); ++handle)
+		{
+			const auto& frames = groups[handle];
+			if (frames.empty())
+			{
+				continue;
+			}
+
+			const NRRegisteredProfile& entry = *Entries[handle];
+			const auto& view = entry.ProfileSolver->GetView();
+			const size_t inCount = view.GetInputSize();
+			const size_t outCount = view.GetOutputSize();
+			if (inCount == 0)
+			{
+				continue;
+			}
+
+			// One row per frame, short frames are left unsolved
+			std::vector<size_t> rows;
+			batch.clear();
+			batch.reserve(frames.size() * inCount);
+			for (const size_t frame : frames)
+			{
+				const auto& input = Frames[frame].Input;
+				if (input.size() < inCount)
+				{
+					continue;
+				}
+				batch.insert(batch.end(), input.begin(), input.begin() + static_cast<std::ptrdiff_t>(inCount));
+				rows.push_back(frame);
+			}
+
+			if (rows.empty())
+			{
+				continue;
+			}
+
+			const std::vector<float> outputs = entry.ProfileSolver->Solve(batch);
+			for (size_t r = 0; r < rows.size(); ++r)
+			{
+				const auto first = outputs.begin() + static_cast<std::ptrdiff_t>(r * outCount);
+				results[rows[r]].assign(first, first + static_cast<std::ptrdiff_t>(outCount));
+			}
+		}
+		return results;
+	}
+
+	std::string ProfileRegistry::TopologyKey(const NRCompiledProfile& Compiled)
+	{
+		std::string key;
+		auto append = [&](char Kind, const std::vector<NRDataBlock>& Blocks) {
+			for (const auto& block : Blocks)
+			{
+				// Block names say what each float means, equal sizes alone don't
+				key += Kind + block.Name + '@' + std::to_string(block.Offset) + '+' + std::to_string(block.FloatCount) + ';';
+			}
+		};
+		append('I', Compiled.Profile.Inputs);
+		append('O', Compiled.Profile.Outputs);
+
+		// Same hierarchy, so every output column drives the same bone of the chain
+		key += 'P';
+		for (const int64_t parent : Compiled.Layout.Parents)
+		{
+			key += std::to_string(parent) + ',';
+		}
+		return key;
+	}
+} // namespace NR
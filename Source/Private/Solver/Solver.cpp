@@ -19,7 +19,7 @@ namespace NR
 {
 	std::vector<float> Solver::Solve(const std::vector<float>& Inputs)
 	{
-		int32_t InCount = RigDesc.GetRequiredInputSize();
+		int32_t InCount = RigView.GetInputSize();
 		int32_t batchSize = static_cast<int32_t>(Inputs.size()) / InCount;
 
 		torch::Tensor InputTensor = torch::from_blob((void*)Inputs.data(), {batchSize, InCount}, torch::kFloat32);
@@ -27,9 +27,22 @@ namespace NR
 		torch::NoGradGuard NoGrad;
 		torch::Tensor OutputTensor = NeuralNetwork->Forward(InputTensor).to(torch::kCPU);
 
-		int32_t OutCount = RigDesc.GetRequiredOutputSize();
+		if (bNormalizeRotations && SkeletonLayout.NumBones() > 0)
+		{
+			OutputTensor = OutputTensor.contiguous();
+			auto quat = Kinematics::GatherQuat(SkeletonLayout, OutputTensor);
+			quat = quat / (quat.norm(2, -1, true) + 1e-8);
+			OutputTensor.index_copy_(1, SkeletonLayout.RotIndex, quat.reshape({batchSize, -1}));
+		}
+
+		int32_t OutCount = RigView.GetOutputSize();
 		std::vector<float> Results(OutCount * batchSize);
 		std::memcpy(Results.data(), OutputTensor.data_ptr<float>(), OutputTensor.nbytes());
+
+		if (bConstrainBones && SkeletonLayout.NumBones() > 0)
+		{
+			Kinematics::ConstrainPose(SkeletonLayout, Results.data(), batchSize, OutCount);
+		}
 		return Results;
 	}
 } // namespace NR
@@ -0,0 +1,255 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/Checkpointer.h"
+#include <filesystem>
+#include <sstream>
+
+namespace NR
+{
+	namespace
+	{
+		// Optimizer::state() is keyed by the TensorImpl address, either raw or as a string
+		template<typename TKey>
+		TKey StateKey(const torch::Tensor& Param)
+		{
+			if constexpr (std::is_same_v<TKey, std::string>)
+			{
+				std::ostringstream ss;
+				ss << static_cast<const void*>(Param.unsafeGetTensorImpl());
+				return ss.str();
+			}
+			else
+			{
+				return static_cast<TKey>(Param.unsafeGetTensorImpl());
+			}
+		}
+
+		Checkpointer::ModuleSnapshot CaptureModule(const torch::nn::Module& Module)
+		{
+			Checkpointer::ModuleSnapshot snapshot;
+			for (const auto& param : Module.named_parameters(false))
+			{
+				snapshot.Parameters.emplace_back(param.key(), param.value().detach().clone());
+			}
+			for (const auto& buffer : Module.named_buffers(false))
+			{
+				snapshot.Buffers.emplace_back(buffer.key(), buffer.value().detach().clone());
+			}
+			for (const auto& child : Module.named_children())
+			{
+				snapshot.ChildNames.push_back(child.key());
+				snapshot.Children.push_back(CaptureModule(*child.value()));
+			}
+			return snapshot;
+		}
+
+		void WriteModule(const Checkpointer::ModuleSnapshot& Snapshot, torch::serialize::OutputArchive& Archive)
+		{
+			for (const auto& [name, tensor] : Snapshot.Parameters)
+			{
+				Archive.write(name, tensor);
+			}
+			for (const auto& [name, tensor] : Snapshot.Buffers)
+			{
+				Archive.write(name, tensor, /*is_buffer=*/true);
+			}
+			for (size_t i = 0; i < Snapshot.Children.size(); ++i)
+			{
+				torch::serialize::OutputArchive childArchive(Archive.compilation_unit());
+				WriteModule(Snapshot.Children[i], childArchive);
+				Archive.write(Snapshot.ChildNames[i], childArchive);
+			}
+		}
+	} // namespace
+
+	Checkpointer::Checkpointer(int32_t KeepVersions)
+		: KeepVersions(KeepVersions)
+	{
+	}
+
+	Checkpointer::~Checkpointer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			bStopping = true;
+		}
+		Signal.notify_all();
+
+		if (Worker.joinable())
+		{
+			Worker.join();
+		}
+	}
+
+	void Checkpointer::Save(const torch::nn::Module& Model, const torch::optim::Adam& Optimizer, const std::string& Path)
+	{
+		auto snapshot = Capture(Model, Optimizer, Path);
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Pending = std::move(snapshot);
+
+			// Started on first use, trainers that never checkpoint don't pay for a thread
+			if (!Worker.joinable())
+			{
+				Worker = std::thread(&Checkpointer::Run, this);
+			}
+		}
+		Signal.notify_all();
+	}
+
+	void Checkpointer::Wait()
+	{
+		std::unique_lock<std::mutex> lock(Mutex);
+		Signal.wait(lock, [this] { return !Pending.has_value() && !bWriting; });
+	}
+
+	Checkpointer::Snapshot Checkpointer::Capture(const torch::nn::Module& Model, const torch::optim::Adam& Optimizer, const std::string& Path)
+	{
+		torch::NoGradGuard NoGrad;
+
+		Snapshot snapshot;
+		snapshot.Path = Path;
+		snapshot.Model = CaptureModule(Model);
+
+		using StateMap = std::decay_t<decltype(Optimizer.state())>;
+		using Key = typename StateMap::key_type;
+
+		std::vector<torch::optim::OptimizerParamGroup> groups;
+		std::vector<std::pair<torch::Tensor, torch::Tensor>> paramPairs;
+		for (const auto& group : Optimizer.param_groups())
+		{
+			std::vector<torch::Tensor> params;
+			for (const auto& param : group.params())
+			{
+				params.push_back(param.detach().clone());
+				paramPairs.emplace_back(param, params.back());
+			}
+			groups.emplace_back(std::move(params), group.options().clone());
+		}
+
+		const auto& defaults = static_cast<const torch::optim::AdamOptions&>(Optimizer.defaults());
+		snapshot.Optimizer = std::make_shared<torch::optim::Adam>(std::move(groups), defaults);
+
+		auto& copyState = snapshot.Optimizer->state();
+		for (const auto& [live, copy] : paramPairs)
+		{
+			auto it = Optimizer.state().find(StateKey<Key>(live));
+			if (it == Optimizer.state().end())
+			{
+				continue;
+			}
+
+			const auto& src = static_cast<const torch::optim::AdamParamState&>(*it->second);
+			auto state = std::make_unique<torch::optim::AdamParamState>();
+			state->step(src.step());
+			state->exp_avg(src.exp_avg().clone());
+			state->exp_avg_sq(src.exp_avg_sq().clone());
+			if (src.max_exp_avg_sq().defined())
+			{
+				state->max_exp_avg_sq(src.max_exp_avg_sq().clone());
+			}
+			copyState[StateKey<Key>(copy)] = std::move(state);
+		}
+
+		return snapshot;
+	}
+
+	bool Checkpointer::Write(const Snapshot& Data, int32_t KeepVersions)
+	{
+		namespace fs = std::filesystem;
+
+		try
+		{
+			torch::serialize::OutputArchive archive;
+			WriteModule(Data.Model, archive);
+
+			if (Data.Optimizer)
+			{
+				torch::serialize::OutputArchive optimizerArchive(archive.compilation_unit());
+				Data.Optimizer->save(optimizerArchive);
+				archive.write("optimizer", optimizerArchive);
+			}
+
+			const fs::path target(Data.Path);
+			const fs::path temp(Data.Path + ".tmp");
+			archive.save_to(temp.string());
+
+			// Path.N-1 -> Path.N ... Path -> Path.1
+			if (KeepVersions > 0 && fs::exists(target))
+			{
+				for (int32_t v = KeepVersions - 1; v >= 1; --v)
+				{
+					const fs::path from(Data.Path + "." + std::to_string(v));
+					if (fs::exists(from))
+					{
+						fs::rename(from, Data.Path + "." + std::to_string(v + 1));
+					}
+				}
+				fs::copy_file(target, Data.Path + ".1", fs::copy_options::overwrite_existing);
+			}
+
+			fs::rename(temp, target);
+			return true;
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[Checkpoint] Failed to write " << Data.Path << ": " << e.what() << std::endl;
+			return false;
+		}
+	}
+
+	bool Checkpointer::Load(torch::nn::Module& Model, torch::optim::Adam* Optimizer, const std::string& Path)
+	{
+		torch::serialize::InputArchive archive;
+		archive.load_from(Path);
+		Model.load(archive);
+
+		torch::serialize::InputArchive optimizerArchive;
+		if (Optimizer && archive.try_read("optimizer", optimizerArchive))
+		{
+			Optimizer->load(optimizerArchive);
+			return true;
+		}
+		return false;
+	}
+
+	void Checkpointer::Run()
+	{
+		while (true)
+		{
+			Snapshot snapshot;
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				Signal.wait(lock, [this] { return bStopping || Pending.has_value(); });
+				if (!Pending.has_value())
+				{
+					return;
+				}
+				snapshot = std::move(*Pending);
+				Pending.reset();
+				bWriting = true;
+			}
+
+			Write(snapshot, KeepVersions);
+
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				bWriting = false;
+			}
+			Signal.notify_all();
+		}
+	}
+} // namespace NR
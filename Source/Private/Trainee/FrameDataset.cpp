@@ -0,0 +1,244 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/FrameDataset.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NR
+{
+	FrameDataset::~FrameDataset()
+	{
+		Close();
+	}
+
+	bool FrameDataset::Open(const std::string& Path)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			std::cerr << "[Dataset] Could not open " << Path << std::endl;
+			return false;
+		}
+		FileHandle = file;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			Close();
+			return false;
+		}
+		MappedBytes = static_cast<uint64_t>(size.QuadPart);
+
+		if (MappedBytes >= sizeof(NRDatasetHeader))
+		{
+			MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (MappingHandle)
+			{
+				MappedView = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+			}
+		}
+#else
+		FileHandle = ::open(Path.c_str(), O_RDONLY);
+		if (FileHandle < 0)
+		{
+			std::cerr << "[Dataset] Could not open " << Path << std::endl;
+			return false;
+		}
+
+		struct stat st{};
+		if (fstat(FileHandle, &st) != 0)
+		{
+			Close();
+			return false;
+		}
+		MappedBytes = static_cast<uint64_t>(st.st_size);
+
+		if (MappedBytes >= sizeof(NRDatasetHeader))
+		{
+			void* view = mmap(nullptr, MappedBytes, PROT_READ, MAP_SHARED, FileHandle, 0);
+			if (view != MAP_FAILED)
+			{
+				MappedView = view;
+				madvise(MappedView, MappedBytes, MADV_RANDOM);
+			}
+		}
+#endif
+
+		if (!MappedView)
+		{
+			std::cerr << "[Dataset] Could not map " << Path << std::endl;
+			Close();
+			return false;
+		}
+
+		std::memcpy(&Header, MappedView, sizeof(NRDatasetHeader));
+		const uint64_t payload = MappedBytes - sizeof(NRDatasetHeader);
+		const uint64_t recordBytes = (static_cast<uint64_t>(Header.InputSize) + Header.TargetSize) * sizeof(float);
+
+		if (Header.Magic != NRDatasetHeader::MagicValue || Header.Version != NRDatasetHeader::CurrentVersion || Header.InputSize == 0)
+		{
+			std::cerr << "[Dataset] " << Path << " is not a NeuraRig dataset (or has an unsupported version)." << std::endl;
+			Close();
+			return false;
+		}
+
+		if (Header.FrameCount * recordBytes > payload)
+		{
+			// Recording was interrupted before the header was patched
+			Header.FrameCount = payload / recordBytes;
+			std::cerr << "[Dataset] " << Path << " is truncated, using " << Header.FrameCount << " frames." << std::endl;
+		}
+
+		Records = reinterpret_cast<const float*>(static_cast<const char*>(MappedView) + sizeof(NRDatasetHeader));
+		std::cout << "[Dataset] " << Path << ": " << Header.FrameCount << " frames, input " << Header.InputSize << ", target " << Header.TargetSize << std::endl;
+		return true;
+	}
+
+	void FrameDataset::Close()
+	{
+#ifdef _WIN32
+		if (MappedView)
+		{
+			UnmapViewOfFile(MappedView);
+		}
+		if (MappingHandle)
+		{
+			CloseHandle(MappingHandle);
+		}
+		if (FileHandle)
+		{
+			CloseHandle(FileHandle);
+		}
+		MappingHandle = nullptr;
+		FileHandle = nullptr;
+#else
+		if (MappedView)
+		{
+			munmap(MappedView, MappedBytes);
+		}
+		if (FileHandle >= 0)
+		{
+			::close(FileHandle);
+		}
+		FileHandle = -1;
+#endif
+		MappedView = nullptr;
+		Records = nullptr;
+		MappedBytes = 0;
+		Header = NRDatasetHeader();
+	}
+
+	void FrameDataset::Prefetch(uint64_t First, uint64_t Count) const
+	{
+		if (!Records || First >= Header.FrameCount)
+		{
+			return;
+		}
+
+		Count = std::min(Count, Header.FrameCount - First);
+		const char* begin = reinterpret_cast<const char*>(Input(First));
+		const size_t bytes = static_cast<size_t>(Count * RecordSize() * sizeof(float));
+
+#ifdef _WIN32
+		WIN32_MEMORY_RANGE_ENTRY range{const_cast<char*>(begin), bytes};
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+		// madvise wants a page aligned start
+		const auto page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+		const auto start = reinterpret_cast<uintptr_t>(begin) & ~(page - 1);
+		madvise(reinterpret_cast<void*>(start), bytes + (reinterpret_cast<uintptr_t>(begin) - start), MADV_WILLNEED);
+#endif
+	}
+
+	FrameDatasetWriter::~FrameDatasetWriter()
+	{
+		Close();
+	}
+
+	bool FrameDatasetWriter::Open(const std::string& Path, int32_t InputSize, int32_t TargetSize)
+	{
+		Close();
+
+		Header = NRDatasetHeader();
+		Header.InputSize = static_cast<uint32_t>(std::max(InputSize, 0));
+		Header.TargetSize = static_cast<uint32_t>(std::max(TargetSize, 0));
+
+		File.open(Path, std::ios::binary | std::ios::trunc);
+		if (!File.is_open() || Header.InputSize == 0)
+		{
+			std::cerr << "[Dataset] Could not create " << Path << std::endl;
+			File.close();
+			return false;
+		}
+
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(NRDatasetHeader));
+		return File.good();
+	}
+
+	bool FrameDatasetWriter::Append(const std::vector<float>& Input, const std::vector<float>& Target)
+	{
+		if (Input.size() < Header.InputSize || (Header.TargetSize > 0 && Target.size() < Header.TargetSize))
+		{
+			return false;
+		}
+		return Append(Input.data(), Target.data());
+	}
+
+	bool FrameDatasetWriter::Append(const float* Input, const float* Target)
+	{
+		if (!File.is_open() || !Input || (Header.TargetSize > 0 && !Target))
+		{
+			return false;
+		}
+
+		File.write(reinterpret_cast<const char*>(Input), Header.InputSize * sizeof(float));
+		if (Header.TargetSize > 0)
+		{
+			File.write(reinterpret_cast<const char*>(Target), Header.TargetSize * sizeof(float));
+		}
+
+		++Header.FrameCount;
+		return File.good();
+	}
+
+	void FrameDatasetWriter::Close()
+	{
+		if (!File.is_open())
+		{
+			return;
+		}
+
+		File.seekp(0);
+		File.write(reinterpret_cast<const char*>(&Header), sizeof(NRDatasetHeader));
+		File.close();
+	}
+} // namespace NR
@@ -0,0 +1,295 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/OfflineTrainer.h"
+#include <chrono>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+namespace NR
+{
+	template<FloatingPoint T>
+	OfflineTrainer<T>::OfflineTrainer(Trainee<T>& Trainer, const FrameDataset& Data, NROfflineOptions Options)
+		: Trainer(Trainer)
+		, Data(Data)
+		, Options(std::move(Options))
+	{
+		this->Options.Epochs = std::max(this->Options.Epochs, 1);
+		this->Options.MiniBatch = std::max(this->Options.MiniBatch, 1);
+		this->Options.PrefetchBatches = std::max(this->Options.PrefetchBatches, 1);
+	}
+
+	template<FloatingPoint T>
+	float OfflineTrainer<T>::Run(const EpochCallback& OnEpoch)
+	{
+		const auto& profile = Trainer.GetProfile();
+		if (!Data.IsOpen() || Data.FrameCount() == 0)
+		{
+			std::cerr << "[Offline] Dataset is empty or not open." << std::endl;
+			return -1.0f;
+		}
+		if (Data.InputSize() != profile.GetRequiredInputSize())
+		{
+			std::cerr << "[Offline] Dataset input size " << Data.InputSize() << " does not match the profile (" << profile.GetRequiredInputSize() << ")." << std::endl;
+			return -1.0f;
+		}
+		if (Data.HasTargets() && Data.TargetSize() != profile.GetRequiredOutputSize())
+		{
+			std::cerr << "[Offline] Dataset target size " << Data.TargetSize() << " does not match the profile (" << profile.GetRequiredOutputSize() << ")." << std::endl;
+			return -1.0f;
+		}
+
+		bCancelled = false;
+		BoundedQueue<Batch> queue(static_cast<size_t>(Options.PrefetchBatches));
+		std::thread producer([&] {
+			Produce(queue);
+			queue.Close();
+		});
+
+		// Temporal losses only make sense between consecutive frames
+		const bool bShuffled = Options.bShuffle;
+		const auto start = std::chrono::steady_clock::now();
+
+		float lastMean = -1.0f;
+		double lossSum = 0.0;
+		uint64_t steps = 0;
+		int32_t epoch = 0;
+
+		while (auto batch = queue.Pop())
+		{
+			if (bCancelled)
+			{
+				break;
+			}
+
+			if (batch->bEpochEnd)
+			{
+				lastMean = steps > 0 ? static_cast<float>(lossSum / static_cast<double>(steps)) : 0.0f;
+				const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+				std::cout << "[Offline] Epoch " << epoch + 1 << "/" << Options.Epochs << " | Loss: " << lastMean << " | Steps: " << steps << " | " << seconds << "s" << std::endl;
+
+				if (!Options.CheckpointPath.empty())
+				{
+					Trainer.SaveCheckpointAsync(Options.CheckpointPath);
+				}
+				if (OnEpoch)
+				{
+					OnEpoch(epoch, lastMean);
+				}
+
+				++epoch;
+				lossSum = 0.0;
+				steps = 0;
+				continue;
+			}
+
+			if (bShuffled)
+			{
+				Trainer.ClearHistory();
+			}
+
+			lossSum += Trainer.TrainStep(batch->Input, batch->Target);
+			++steps;
+		}
+
+		queue.Close();
+		producer.join();
+		return lastMean;
+	}
+
+	template<FloatingPoint T>
+	void OfflineTrainer<T>::Produce(BoundedQueue<Batch>& Queue)
+	{
+		const uint64_t frameCount = Data.FrameCount();
+		const uint64_t miniBatch = static_cast<uint64_t>(Options.MiniBatch);
+		const bool bPerFrame = Data.HasTargets();
+
+		std::mt19937_64 rng(Options.Seed);
+		std::vector<uint64_t> order(bPerFrame ? frameCount : (frameCount + miniBatch - 1) / miniBatch);
+		std::iota(order.begin(), order.end(), 0);
+
+		std::vector<uint64_t> frames;
+		frames.reserve(miniBatch);
+
+		// A shuffled window needs the state the windows before it leave behind
+		WindowStates.clear();
+		if (!bPerFrame && Options.bShuffle)
+		{
+			for (uint64_t w = 0; w < order.size() && !bCancelled; ++w)
+			{
+				EnterWindow(w);
+				WindowFrames(w, frames);
+				Gather(frames);
+			}
+		}
+
+		for (int32_t epoch = 0; epoch < Options.Epochs && !bCancelled; ++epoch)
+		{
+			if (Options.bShuffle)
+			{
+				std::shuffle(order.begin(), order.end(), rng);
+			}
+
+			for (size_t i = 0; i < order.size() && !bCancelled;)
+			{
+				frames.clear();
+				if (bPerFrame)
+				{
+					for (; i < order.size() && frames.size() < miniBatch; ++i)
+					{
+						frames.push_back(order[i]);
+					}
+				}
+				else
+				{
+					EnterWindow(order[i]);
+					WindowFrames(order[i++], frames);
+				}
+
+				// Let the OS page in the next window while this one is gathered
+				if (!bPerFrame && i < order.size())
+				{
+					Data.Prefetch(order[i] * miniBatch, miniBatch);
+				}
+				else if (!Options.bShuffle)
+				{
+					Data.Prefetch(frames.back() + 1, miniBatch);
+				}
+
+				if (!Queue.Push(Gather(frames)))
+				{
+					return;
+				}
+			}
+
+			Batch end;
+			end.bEpochEnd = true;
+			if (!Queue.Push(std::move(end)))
+			{
+				return;
+			}
+		}
+	}
+
+	template<FloatingPoint T>
+	void OfflineTrainer<T>::WindowFrames(uint64_t Window, std::vector<uint64_t>& Frames) const
+	{
+		const uint64_t miniBatch = static_cast<uint64_t>(Options.MiniBatch);
+		const uint64_t first = Window * miniBatch;
+
+		Frames.clear();
+		for (uint64_t f = first; f < std::min(first + miniBatch, Data.FrameCount()); ++f)
+		{
+			Frames.push_back(f);
+		}
+	}
+
+	template<FloatingPoint T>
+	void OfflineTrainer<T>::EnterWindow(uint64_t Window)
+	{
+		if (Window < WindowStates.size())
+		{
+			Trainer.LoadGaitContext(WindowStates[Window]);
+			return;
+		}
+
+		// Reached in recorded order, by the first pass or by an unshuffled first epoch
+		WindowStates.resize(Window + 1);
+		WindowStates[Window] = Trainer.CreateGaitContext();
+	}
+
+	template<FloatingPoint T>
+	typename OfflineTrainer<T>::Batch OfflineTrainer<T>::Gather(const std::vector<uint64_t>& Frames)
+	{
+		const auto rows = static_cast<int64_t>(Frames.size());
+		const int64_t inCount = Data.InputSize();
+
+		Batch batch;
+		batch.Input = torch::empty({rows, inCount}, torch::kFloat);
+		float* inputDst = batch.Input.data_ptr<float>();
+		for (int64_t r = 0; r < rows; ++r)
+		{
+			std::memcpy(inputDst + r * inCount, Data.Input(Frames[r]), inCount * sizeof(float));
+		}
+
+		if (Data.HasTargets())
+		{
+			const int64_t outCount = Data.TargetSize();
+			batch.Target = torch::empty({rows, outCount}, torch::kFloat);
+			float* targetDst = batch.Target.data_ptr<float>();
+			for (int64_t r = 0; r < rows; ++r)
+			{
+				std::memcpy(targetDst + r * outCount, Data.Target(Frames[r]), outCount * sizeof(float));
+			}
+		}
+		else
+		{
+			// Only this thread touches the trainee's rule evaluator during Run()
+			batch.Target = Trainer.ComputeTargets(batch.Input);
+		}
+
+		return batch;
+	}
+
+	template<FloatingPoint T>
+	bool OfflineTrainer<T>::BakeTargets(Trainee<T>& Trainer, const FrameDataset& Source, const std::string& Path, int32_t Chunk)
+	{
+		const auto& profile = Trainer.GetProfile();
+		const int64_t inCount = Source.InputSize();
+		const int64_t outCount = profile.GetRequiredOutputSize();
+
+		if (!Source.IsOpen() || inCount != profile.GetRequiredInputSize())
+		{
+			std::cerr << "[Offline] Cannot bake targets, dataset does not match the profile." << std::endl;
+			return false;
+		}
+
+		FrameDatasetWriter writer;
+		if (!writer.Open(Path, static_cast<int32_t>(inCount), static_cast<int32_t>(outCount)))
+		{
+			return false;
+		}
+
+		const uint64_t chunk = static_cast<uint64_t>(std::max(Chunk, 1));
+		for (uint64_t first = 0; first < Source.FrameCount(); first += chunk)
+		{
+			const auto rows = static_cast<int64_t>(std::min(chunk, Source.FrameCount() - first));
+
+			auto input = torch::empty({rows, inCount}, torch::kFloat);
+			for (int64_t r = 0; r < rows; ++r)
+			{
+				std::memcpy(input.data_ptr<float>() + r * inCount, Source.Input(first + r), inCount * sizeof(float));
+			}
+
+			auto target = Trainer.ComputeTargets(input).contiguous();
+			for (int64_t r = 0; r < rows; ++r)
+			{
+				if (!writer.Append(input.data_ptr<float>() + r * inCount, target.data_ptr<float>() + r * outCount))
+				{
+					std::cerr << "[Offline] Failed writing " << Path << std::endl;
+					return false;
+				}
+			}
+		}
+
+		writer.Close();
+		std::cout << "[Offline] Baked targets for " << Source.FrameCount() << " frames into " << Path << std::endl;
+		return true;
+	}
+
+	template class OfflineTrainer<float>;
+	template class OfflineTrainer<double>;
+} // namespace NR
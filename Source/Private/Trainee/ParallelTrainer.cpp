@@ -0,0 +1,229 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/ParallelTrainer.h"
+
+namespace NR
+{
+	template<FloatingPoint T>
+	ParallelTrainer<T>::ParallelTrainer(std::shared_ptr<IModel<T> > SharedModel, ModelFactory Factory, IQuat* QCustom, const NRModelProfile& Rig, int32_t NumWorkers, int32_t MiniBatch, const double LearningRate)
+		: InCount(Rig.GetRequiredInputSize())
+		, MiniBatch(std::max(MiniBatch, 1))
+	{
+		if (NumWorkers <= 0)
+		{
+			NumWorkers = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+		}
+
+		// One op per worker, otherwise every worker fans out over all cores again
+		PreviousThreads = torch::get_num_threads();
+		torch::set_num_threads(1);
+
+		for (int32_t i = 0; i < NumWorkers; ++i)
+		{
+			auto model = SharedModel;
+			if (i > 0)
+			{
+				if (!Factory)
+				{
+					std::cerr << "[ParallelTrainer] No model factory, training with a single worker." << std::endl;
+					break;
+				}
+
+				model = Factory();
+				if (!model || !ShareStorage(*model, *SharedModel))
+				{
+					std::cerr << "[ParallelTrainer] Replica " << i << " does not match the shared model, skipped." << std::endl;
+					continue;
+				}
+				model->train();
+			}
+
+			Rules evaluator;
+			auto worker = std::make_unique<Worker>();
+			worker->Model = model;
+			worker->Trainer = std::make_unique<Trainee<T> >(model, QCustom, Rig, evaluator, LearningRate);
+			Workers.push_back(std::move(worker));
+		}
+
+		// One producer keeps the gait clock in frame order, whichever worker trains the frame
+		Targets = std::make_unique<TargetPipeline<T> >(*Workers.front()->Trainer, Workers.size() * 2);
+
+		for (auto& worker : Workers)
+		{
+			worker->Thread = std::thread(&ParallelTrainer::Run, this, std::ref(*worker));
+		}
+
+		std::cout << "[ParallelTrainer] " << Workers.size() << " workers, minibatch " << this->MiniBatch << std::endl;
+	}
+
+	template<FloatingPoint T>
+	ParallelTrainer<T>::~ParallelTrainer()
+	{
+		Stop();
+	}
+
+	template<FloatingPoint T>
+	bool ParallelTrainer<T>::Submit(std::vector<float> InputFloats)
+	{
+		std::lock_guard<std::mutex> lock(SubmitMutex);
+		if (bStopped)
+		{
+			return false;
+		}
+
+		// Oversized datagrams would otherwise shift every row batched after them
+		const size_t frameFloats = InCount > 0 ? InputFloats.size() - InputFloats.size() % static_cast<size_t>(InCount) : 0;
+		Batch.insert(Batch.end(), InputFloats.begin(), InputFloats.begin() + static_cast<std::ptrdiff_t>(frameFloats));
+
+		const size_t batchFloats = static_cast<size_t>(MiniBatch) * InCount;
+		while (batchFloats > 0 && Batch.size() >= batchFloats)
+		{
+			std::vector<float> full(Batch.begin(), Batch.begin() + static_cast<std::ptrdiff_t>(batchFloats));
+			Batch.erase(Batch.begin(), Batch.begin() + static_cast<std::ptrdiff_t>(batchFloats));
+			if (!Targets->Submit(std::move(full)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<FloatingPoint T>
+	void ParallelTrainer<T>::Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(SubmitMutex);
+			if (!bStopped && !Batch.empty() && Targets)
+			{
+				Targets->Submit(std::move(Batch));
+			}
+			Batch.clear();
+			bStopped = true;
+		}
+
+		// Workers drain the prepared minibatches, then Take() returns nullopt
+		if (Targets)
+		{
+			Targets->Finish();
+		}
+		for (auto& worker : Workers)
+		{
+			if (worker->Thread.joinable())
+			{
+				worker->Thread.join();
+			}
+		}
+
+		if (PreviousThreads > 0)
+		{
+			torch::set_num_threads(PreviousThreads);
+			PreviousThreads = 0;
+		}
+	}
+
+	template<FloatingPoint T>
+	void ParallelTrainer<T>::SaveCheckpointAsync(const std::string& Path)
+	{
+		std::lock_guard<std::mutex> lock(CheckpointMutex);
+		CheckpointPath = Path;
+	}
+
+	template<FloatingPoint T>
+	void ParallelTrainer<T>::SavePendingCheckpoint(Trainee<T>& Trainer)
+	{
+		std::optional<std::string> path;
+		{
+			std::lock_guard<std::mutex> lock(CheckpointMutex);
+			path = std::move(CheckpointPath);
+			CheckpointPath.reset();
+		}
+
+		if (path)
+		{
+			Trainer.SaveCheckpointAsync(*path);
+		}
+	}
+
+	template<FloatingPoint T>
+	void ParallelTrainer<T>::Run(Worker& Self)
+	{
+		// Only the first worker steps the optimizer the checkpoints are taken from
+		const bool bCheckpoints = &Self == Workers.front().get();
+
+		while (auto prepared = Targets->Take())
+		{
+			try
+			{
+				// The previous minibatch of this worker is not the one before this frame
+				Self.Trainer->ClearHistory();
+				const float loss = Self.Trainer->TrainStep(prepared->first, prepared->second);
+				LossValue.store(loss, std::memory_order_relaxed);
+				StepCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "[ParallelTrainer] Train step failed: " << e.what() << std::endl;
+			}
+
+			if (bCheckpoints)
+			{
+				SavePendingCheckpoint(*Self.Trainer);
+			}
+		}
+
+		if (bCheckpoints)
+		{
+			SavePendingCheckpoint(*Self.Trainer);
+		}
+	}
+
+	template<FloatingPoint T>
+	bool ParallelTrainer<T>::ShareStorage(torch::nn::Module& Replica, const torch::nn::Module& Source)
+	{
+		torch::NoGradGuard NoGrad;
+
+		auto dstParams = Replica.parameters();
+		auto srcParams = Source.parameters();
+		auto dstBuffers = Replica.buffers();
+		auto srcBuffers = Source.buffers();
+		if (dstParams.size() != srcParams.size() || dstBuffers.size() != srcBuffers.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < dstParams.size(); ++i)
+		{
+			if (dstParams[i].sizes() != srcParams[i].sizes())
+			{
+				return false;
+			}
+		}
+
+		// set_data swaps the storage but keeps each replica's own grad and autograd state
+		for (size_t i = 0; i < dstParams.size(); ++i)
+		{
+			dstParams[i].set_data(srcParams[i].detach());
+		}
+		for (size_t i = 0; i < dstBuffers.size(); ++i)
+		{
+			dstBuffers[i].set_data(srcBuffers[i].detach());
+		}
+		return true;
+	}
+
+	template class ParallelTrainer<float>;
+	template class ParallelTrainer<double>;
+} // namespace NR
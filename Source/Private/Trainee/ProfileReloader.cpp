@@ -0,0 +1,79 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/ProfileReloader.h"
+#include "Core/Parse.h"
+#include <iostream>
+
+namespace NR
+{
+	ProfileReloader::ProfileReloader(std::string IKPath, std::string SKPath, std::string TWPath, IQuat* Quat,
+	                                 std::string CachePath, Rules Base)
+		: IKPath(std::move(IKPath))
+		, SKPath(std::move(SKPath))
+		, TWPath(std::move(TWPath))
+		, CachePath(std::move(CachePath))
+		, Quat(Quat)
+		, Base(std::move(Base))
+		, Watcher({this->IKPath, this->SKPath, this->TWPath}, [this] { Rebuild(); })
+	{
+	}
+
+	bool ProfileReloader::Start()
+	{
+		return Watcher.Start();
+	}
+
+	void ProfileReloader::Stop()
+	{
+		Watcher.Stop();
+	}
+
+	std::optional<NRCompiledProfile> ProfileReloader::TakePending()
+	{
+		std::lock_guard<std::mutex> lock(PendingMutex);
+		std::optional<NRCompiledProfile> taken = std::move(Pending);
+		Pending.reset();
+		return taken;
+	}
+
+	void ProfileReloader::Rebuild()
+	{
+		NRModelProfile profile;
+		bool bLoaded;
+		if (!CachePath.empty())
+		{
+			bLoaded = Parse::LoadProfileCached(IKPath, SKPath, TWPath, CachePath, profile, Quat);
+		}
+		else
+		{
+			bLoaded = Parse::LoadIKFromJson(IKPath, profile)
+				&& Parse::LoadSKFromJson(SKPath, profile.Skeleton, Quat)
+				&& Parse::LoadTWFromJson(TWPath, profile.TrainingWeights);
+		}
+
+		if (!bLoaded)
+		{
+			std::cerr << "[ProfileReloader] Reload failed, keeping the current profile: " << IKPath << std::endl;
+			return;
+		}
+
+		NRCompiledProfile compiled = NRCompiledProfile::Compile(std::move(profile), Base);
+		std::cout << "[ProfileReloader] Profile rebuilt: " << compiled.Profile.ProfileName << std::endl;
+
+		std::lock_guard<std::mutex> lock(PendingMutex);
+		Pending = std::move(compiled);
+	}
+} // namespace NR
@@ -0,0 +1,198 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#include "Trainee/TargetPipeline.h"
+
+namespace NR
+{
+	namespace
+	{
+		template<typename TDuration>
+		double ToMs(TDuration Duration)
+		{
+			return std::chrono::duration<double, std::milli>(Duration).count();
+		}
+	} // namespace
+
+	template<FloatingPoint T>
+	TargetPipeline<T>::TargetPipeline(Trainee<T>& Trainer, size_t Depth)
+		: Trainer(Trainer)
+		, InCount(Trainer.GetProfile().GetRequiredInputSize())
+		, Pending(Depth)
+		, Ready(Depth)
+	{
+		Producer = std::thread(&TargetPipeline::Produce, this);
+	}
+
+	template<FloatingPoint T>
+	TargetPipeline<T>::~TargetPipeline()
+	{
+		Stop();
+	}
+
+	template<FloatingPoint T>
+	bool TargetPipeline<T>::Submit(std::vector<float> InputFloats)
+	{
+		return Pending.Push(std::move(InputFloats));
+	}
+
+	template<FloatingPoint T>
+	bool TargetPipeline<T>::TrySubmit(std::vector<float> InputFloats)
+	{
+		if (Pending.TryPush(std::move(InputFloats)))
+		{
+			return true;
+		}
+
+		std::lock_guard<std::mutex> lock(StatsMutex);
+		++Totals.Dropped;
+		return false;
+	}
+
+	template<FloatingPoint T>
+	std::optional<float> TargetPipeline<T>::Step()
+	{
+		auto item = Ready.Pop();
+		if (!item)
+		{
+			return std::nullopt;
+		}
+		return Train(*item);
+	}
+
+	template<FloatingPoint T>
+	std::optional<float> TargetPipeline<T>::TryStep()
+	{
+		auto item = Ready.TryPop();
+		if (!item)
+		{
+			return std::nullopt;
+		}
+		return Train(*item);
+	}
+
+	template<FloatingPoint T>
+	std::optional<std::pair<torch::Tensor, torch::Tensor> > TargetPipeline<T>::Take()
+	{
+		auto item = Ready.Pop();
+		if (!item)
+		{
+			return std::nullopt;
+		}
+		return std::make_pair(std::move(item->Input), std::move(item->Target));
+	}
+
+	template<FloatingPoint T>
+	void TargetPipeline<T>::Finish()
+	{
+		// The producer closes Ready after the last queued frame
+		Pending.Close();
+		if (Producer.joinable())
+		{
+			Producer.join();
+		}
+	}
+
+	template<FloatingPoint T>
+	void TargetPipeline<T>::Stop()
+	{
+		// A producer blocked on a full Ready queue gives up its frame instead of waiting for a step
+		Pending.Close();
+		Ready.StopWaiting();
+		if (Producer.joinable())
+		{
+			Producer.join();
+		}
+		Ready.Close();
+	}
+
+	template<FloatingPoint T>
+	NRPipelineStats TargetPipeline<T>::Stats() const
+	{
+		std::lock_guard<std::mutex> lock(StatsMutex);
+
+		NRPipelineStats stats = Totals;
+		if (Evaluated > 0)
+		{
+			stats.TargetMs /= static_cast<double>(Evaluated);
+		}
+		if (Totals.Steps > 0)
+		{
+			stats.QueueMs /= static_cast<double>(Totals.Steps);
+			stats.StepMs /= static_cast<double>(Totals.Steps);
+		}
+		return stats;
+	}
+
+	template<FloatingPoint T>
+	std::unique_lock<std::mutex> TargetPipeline<T>::LockTrainer()
+	{
+		return std::unique_lock<std::mutex>(TrainerMutex);
+	}
+
+	template<FloatingPoint T>
+	void TargetPipeline<T>::Produce()
+	{
+		const auto options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCPU);
+
+		while (auto frame = Pending.Pop())
+		{
+			const auto batchSize = static_cast<int64_t>(frame->size()) / InCount;
+			if (batchSize == 0)
+			{
+				continue;
+			}
+
+			const auto start = Clock::now();
+
+			Prepared item;
+			item.Input = torch::from_blob(frame->data(), {batchSize, InCount}, options).clone();
+			{
+				std::lock_guard<std::mutex> lock(TrainerMutex);
+				item.Target = Trainer.ComputeTargets(item.Input);
+			}
+			item.ReadyAt = Clock::now();
+
+			{
+				std::lock_guard<std::mutex> lock(StatsMutex);
+				Totals.TargetMs += ToMs(item.ReadyAt - start);
+				++Evaluated;
+			}
+
+			if (!Ready.Push(std::move(item)))
+			{
+				return;
+			}
+		}
+		Ready.Close();
+	}
+
+	template<FloatingPoint T>
+	float TargetPipeline<T>::Train(Prepared& Item)
+	{
+		const auto start = Clock::now();
+		const float loss = Trainer.TrainStep(Item.Input, Item.Target);
+		const auto end = Clock::now();
+
+		std::lock_guard<std::mutex> lock(StatsMutex);
+		Totals.QueueMs += ToMs(start - Item.ReadyAt);
+		Totals.StepMs += ToMs(end - start);
+		++Totals.Steps;
+		return loss;
+	}
+
+	template class TargetPipeline<float>;
+	template class TargetPipeline<double>;
+} // namespace NR
@@ -16,7 +16,9 @@
 #include "Trainee/Trainee.h"
 
 #include <ranges>
+#include <unordered_set>
 
+#include "Core/Kinematics.h"
 #include "Core/Rules.h"
 #include "Core/Types.h"
 
@@ -26,9 +28,9 @@ namespace NR
 	Trainee<T>::Trainee(std::shared_ptr<IModel<T> > TargetModel, IQuat* QCustom, NRModelProfile Rig, Rules& Ev, const double LearningRate)
 		: TargetModel(TargetModel)
 		, QuatConverter(QCustom)
-		  , Evaluator(Ev)
-		  , RigDesc(std::move(Rig))
 	{
+		Adopt(NRCompiledProfile::Compile(std::move(Rig), Ev));
+
 		double finalLR = LearningRate;
 		if (RigDesc.TrainingWeights.HyperParameters.LearningRate > 0)
 		{
@@ -40,22 +42,81 @@ namespace NR
 		auto T_size = RigDesc.GetRequiredOutputSize();
 		IdealTargets = torch::zeros_like(torch::empty({1, T_size}));
 		Predicated = torch::zeros_like(torch::empty({1, T_size}));
+	}
+
+	template<FloatingPoint T>
+	void Trainee<T>::Adopt(NRCompiledProfile&& Compiled)
+	{
+		// The evaluators keep references into Evaluator and RigDesc
+		TensorTargets.reset();
+		BulkTargets.reset();
+
+		RigDesc = std::move(Compiled.Profile);
+		RigView = NRProfileView(RigDesc);
+		Evaluator = std::move(Compiled.Evaluator);
+		SkeletonLayout = std::move(Compiled.Layout);
+		Weights = std::move(Compiled.Weights);
+
+		BulkTargets = std::make_unique<BulkEvaluator>(Evaluator, RigDesc);
+	}
 
-		auto B_size = RigDesc.Bindings.size();
-		for (auto i = 0; i < B_size; ++i)
+	template<FloatingPoint T>
+	bool Trainee<T>::Reload(NRCompiledProfile&& Compiled)
+	{
+		if (!NRCompiledProfile::SameLayout(RigDesc, Compiled.Profile))
 		{
-			int R_size = RigDesc.Bindings[i].Rules.size();
-			for (auto j = 0; j < R_size; ++j)
+			std::cerr << "[Trainee] Reloaded profile changes the input/output layout, restart required" << std::endl;
+			return false;
+		}
+
+		// Gait clock and rule variables carry over by name, so the phase does not jump;
+		// constants follow the reloaded file
+		NRGaitContext state = Compiled.Evaluator.CreateContext();
+		state.DeltaTime = Evaluator.deltaTime;
+		for (size_t b = 0; b < state.Values.size() && b < Evaluator.Vars.size(); ++b)
+		{
+			std::unordered_set<std::string> constants;
+			if (b < Compiled.Profile.Bindings.size())
 			{
-				auto& F_rule = RigDesc.Bindings[i].Rules[j];
-				if (F_rule.Name.empty())
+				for (const auto& rule : Compiled.Profile.Bindings[b].Rules)
 				{
-					std::cerr << "[Trainee] Rule not found: " << RigDesc.Bindings[i].RuleName << std::endl;
-					continue;
+					for (const auto& [name, _value] : rule.GetConstants())
+					{
+						constants.insert(name);
+					}
 				}
-				Evaluator.Setup(F_rule, i);
+			}
+
+			size_t i = 0;
+			for (const auto& [name, _value] : Compiled.Evaluator.Vars[b])
+			{
+				const auto previous = Evaluator.Vars[b].find(name);
+				if (previous != Evaluator.Vars[b].end() && !constants.contains(name))
+				{
+					state.Values[b][i] = previous->second;
+				}
+				++i;
+			}
+		}
+
+		const bool bTensorTargets = TensorTargets != nullptr;
+		Adopt(std::move(Compiled));
+		Evaluator.LoadContext(state);
+		if (bTensorTargets)
+		{
+			UseTensorTargets(true);
+		}
+
+		// Model and optimizer state are kept, only the learning rate follows the TW file
+		const double learningRate = RigDesc.TrainingWeights.HyperParameters.LearningRate;
+		if (learningRate > 0)
+		{
+			for (auto& group : Optimizer->param_groups())
+			{
+				static_cast<torch::optim::AdamOptions&>(group.options()).lr(learningRate);
 			}
 		}
+		return true;
 	}
 
 	template<FloatingPoint T>
@@ -96,50 +157,81 @@ namespace NR
 	template<FloatingPoint T>
 	float Trainee<T>::TrainStep(const std::vector<float>& InputFloats)
 	{
-		int32_t InCount = RigDesc.GetRequiredInputSize();
+		int32_t InCount = RigView.GetInputSize();
 		int32_t BatchSize = static_cast<int32_t>(InputFloats.size()) / InCount;
 
 		const auto options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCPU);
 		auto InputTensor = torch::from_blob((void*)InputFloats.data(), {BatchSize, InCount}, options).clone();
 
-		Optimizer->zero_grad();
-		auto Prediction = TargetModel->Forward(InputTensor);
+		return TrainStep(InputTensor, ComputeTargets(InputTensor));
+	}
+
+	template<FloatingPoint T>
+	torch::Tensor Trainee<T>::ComputeTargets(const torch::Tensor& Input)
+	{
+		const int64_t BatchSize = Input.dim() > 1 ? Input.size(0) : 1;
+		const int64_t OutCount = RigView.GetOutputSize();
+		auto Rows = Input.reshape({BatchSize, -1});
 
-		// Calculate Ideal Target for this input
-		auto T_ideal = torch::zeros_like(Prediction);
-		for (size_t i = 0; i < RigDesc.Bindings.size(); ++i)
+		if (TensorTargets)
 		{
-			auto& varMap = Evaluator.Parsers[i].GetVar();
-			auto& binding = RigDesc.Bindings[i];
+			return TensorTargets->Evaluate(Rows, OutCount);
+		}
 
-			for (const auto& F_rule : binding.Rules)
-			{
-				if (F_rule.Logic.empty())
-					continue;
+		// Filled on the host and uploaded once, instead of one indexed write per value
+		std::vector<float> Targets(static_cast<size_t>(BatchSize * OutCount), 0.0f);
+		if (BatchSize > 1 && BulkTargets)
+		{
+			BulkTargets->Evaluate(Rows, Targets.data(), OutCount);
+			return torch::from_blob(Targets.data(), {BatchSize, OutCount}, torch::kFloat).clone();
+		}
 
-				Evaluator.SetTensorInputs(i, F_rule, RigDesc, InputTensor);
-				for (const auto& [Name, Expr] : F_rule.Logic)
-				{
-					if (auto it = varMap.find(Name); it != varMap.end())
-						*(it->second) = Evaluator.Eval(i, Expr);
-				}
+		// Rules read the input frames straight from their floats
+		const auto Frames = Rows.to(torch::kCPU, torch::kFloat).contiguous();
+		const int64_t InCount = Frames.size(1);
+		const float* In = Frames.data_ptr<float>();
 
-				for (const auto& [Id, Condition, Formulas] : F_rule.Phases)
-				{
-					if (Evaluator.Eval(i, Condition) == 0)
-						continue;
+		for (int64_t b = 0; b < BatchSize; ++b)
+		{
+			const float* Row = In + b * InCount;
+			float* T_row = Targets.data() + b * OutCount;
 
-					int B_idx = 0;
-					for (const auto& [formulaName, expr] : Formulas)
-					{
-						T_ideal[0][binding.Offset + B_idx] = Evaluator.Eval(i, expr);
-						++B_idx;
-					}
-					break;
-				}
+			for (size_t i = 0; i < RigDesc.Bindings.size(); ++i)
+			{
+				Evaluator.EvaluateBinding(static_cast<int>(i), RigDesc, Row, T_row, OutCount);
 			}
 		}
 
+		return torch::from_blob(Targets.data(), {BatchSize, OutCount}, torch::kFloat).clone();
+	}
+
+	template<FloatingPoint T>
+	bool Trainee<T>::UseTensorTargets(bool bEnable)
+	{
+		if (!bEnable)
+		{
+			TensorTargets.reset();
+			return true;
+		}
+
+		auto lowered = std::make_unique<TensorRules>(Evaluator, RigDesc);
+		if (!lowered->IsValid())
+		{
+			std::cerr << "[Trainee] Rules could not be lowered to tensors, keeping muParser" << std::endl;
+			return false;
+		}
+
+		TensorTargets = std::move(lowered);
+		return true;
+	}
+
+	template<FloatingPoint T>
+	float Trainee<T>::TrainStep(const torch::Tensor& InputTensor, const torch::Tensor& Target)
+	{
+		Optimizer->zero_grad();
+		auto Prediction = TargetModel->Forward(InputTensor);
+		auto T_ideal = Target.to(Prediction.options());
+
 		auto Result = ComputeLoss(Prediction, T_ideal, InputTensor, PredHistory);
 
 		Result.TotalLoss.backward();
@@ -155,7 +247,7 @@ namespace NR
 			PredictionCandidates.erase(PredictionCandidates.begin());
 
 		float emaAlpha = RigDesc.TrainingWeights.HyperParameters.EmaAlpha;
-		if (!SmoothedOutput.defined())
+		if (!SmoothedOutput.defined() || SmoothedOutput.sizes() != Prediction.sizes())
 			SmoothedOutput = Prediction.detach().clone();
 		else
 			SmoothedOutput = SmoothedOutput * (1.0f - emaAlpha) + Prediction.detach() * emaAlpha;
@@ -169,17 +261,15 @@ namespace NR
 	template<FloatingPoint T>
 	IKLossResult Trainee<T>::ComputeLoss(const torch::Tensor& Pred, const torch::Tensor& Target, const torch::Tensor& Input, const torch::Tensor& PrevPred)
 	{
-		const auto& TW = RigDesc.TrainingWeights;
 		IKLossResult res;
 		res.TotalLoss = torch::tensor(0.0f, Pred.options());
 
-		auto getWeight = [&](const std::string& name) {
-			auto it = TW.LossWeights.find(name);
-			return (it != TW.LossWeights.end()) ? it->second.Weight : 1.0f;
+		auto getWeight = [&](NRLossSlot slot) {
+			return Weights.Get(slot);
 		};
 
-		auto Pre_p = Pred.index({0, torch::indexing::Slice(0, 7)});
-		auto Target_p = Target.index({0, torch::indexing::Slice(0, 7)});
+		auto Pre_p = Pred.index({torch::indexing::Slice(), torch::indexing::Slice(0, 7)});
+		auto Target_p = Target.index({torch::indexing::Slice(), torch::indexing::Slice(0, 7)});
 
 		// Quaternion Norm Loss
 		res.QuaternionNormLoss = torch::tensor(0.0f, Pred.options());
@@ -187,14 +277,19 @@ namespace NR
 
 		// 1. Kinematics Loss (FK)
 		res.KinematicsLoss = ComputeFK(Pred, Target);
-		res.TotalLoss = res.TotalLoss + res.KinematicsLoss * getWeight("Objective");
-		res.PositionLoss = torch::mse_loss(Pre_p, Target_p) * getWeight("Position");
+		res.TotalLoss = res.TotalLoss + res.KinematicsLoss * getWeight(NRLossSlot::Objective);
+		res.PositionLoss = torch::mse_loss(Pre_p, Target_p) * getWeight(NRLossSlot::Position);
 
 		// 3. Temporal Loss
-		if (PrevPred.defined() && PrevPred.numel() > 0)
+		// History tensors from a minibatch of another size are skipped
+		auto sameShape = [&](const torch::Tensor& t) {
+			return t.defined() && t.sizes() == Pred.sizes();
+		};
+
+		if (sameShape(PrevPred))
 		{
 			res.TemporalLoss = torch::mse_loss(Pred, PrevPred);
-			res.TotalLoss = res.TotalLoss + res.TemporalLoss * getWeight("Temporal");
+			res.TotalLoss = res.TotalLoss + res.TemporalLoss * getWeight(NRLossSlot::Temporal);
 		}
 		else
 		{
@@ -202,12 +297,12 @@ namespace NR
 		}
 
 		// 4. Acceleration Loss
-		if (PredHistory2.defined() && PredHistory2.numel() > 0)
+		if (sameShape(PrevPred) && sameShape(PredHistory2))
 		{
 			auto velNow = (Pred - PrevPred);
 			auto velPrev = (PrevPred - PredHistory2);
 			res.AccelerationLoss = torch::mse_loss(velNow, velPrev);
-			res.TotalLoss = res.TotalLoss + res.AccelerationLoss * getWeight("Acceleration");
+			res.TotalLoss = res.TotalLoss + res.AccelerationLoss * getWeight(NRLossSlot::Acceleration);
 		}
 		else
 		{
@@ -215,68 +310,53 @@ namespace NR
 		}
 
 		// 5. Smooth Output Loss (Delta to EMA)
-		if (SmoothedOutput.defined())
+		if (sameShape(SmoothedOutput))
 		{
 			res.SmoothOutputLoss = torch::mse_loss(Pred, SmoothedOutput);
-			res.TotalLoss = res.TotalLoss + res.SmoothOutputLoss * getWeight("SmoothOutput");
+			res.TotalLoss = res.TotalLoss + res.SmoothOutputLoss * getWeight(NRLossSlot::SmoothOutput);
 		}
 		else
 		{
 			res.SmoothOutputLoss = torch::tensor(0.0f, Pred.options());
 		}
 
-		auto computeBoneLimitsLoss = [&](const NRSkeleton::Bone& bone) {
-			// Quat [x, y, z, w]
-			auto qDelta = Pred.index({0, torch::indexing::Slice(bone.Offset + 3, bone.Offset + 7)});
-			auto euler = QuatConverter->ToEuler(qDelta);
-
-			// if euler < min -> penalty. if euler > max -> penalty.
-			auto low_penalty = torch::clamp(bone.Limits.Min - euler, 0.0f);
-			auto high_penalty = torch::clamp(euler - bone.Limits.Max, 0.0f);
-
-			torch::Tensor loss = (low_penalty.pow(2) + high_penalty.pow(2)).sum() * getWeight("Objective");
-			return loss;
-		};
+		// Limits of every bone in one pass: [B, NBones, 3] Euler angles against the stacked bounds
+		const IQuat* converter = QuatConverter ? QuatConverter : &FallbackQuat;
+		auto euler = converter->ToEulerBatch(Kinematics::GatherQuat(SkeletonLayout, Pred));
+		auto low_penalty = torch::clamp(SkeletonLayout.LimitMin.to(Pred.options()) - euler, 0.0f);
+		auto high_penalty = torch::clamp(euler - SkeletonLayout.LimitMax.to(Pred.options()), 0.0f);
+		auto boneLimits = (low_penalty.pow(2) + high_penalty.pow(2)).sum(-1).mean(0) * getWeight(NRLossSlot::Objective);
 
-		// Apply parent limits
-		torch::Tensor limitsLoss = torch::tensor(0.0f, Pred.options());
-		limitsLoss = limitsLoss + computeBoneLimitsLoss(RigDesc.Skeleton.Parent);
-		res.TotalLoss = res.TotalLoss + limitsLoss;
-
-		// Apply bone limits
-		for (const auto& chain : RigDesc.Skeleton.Rest)
-		{
-			for (const auto& bone : chain)
-			{
-				limitsLoss = limitsLoss + computeBoneLimitsLoss(bone);
-			}
-		}
+		// Only the parent limits take part in the total, the chain bones are reported
+		torch::Tensor limitsLoss = boneLimits.sum();
+		res.TotalLoss = res.TotalLoss + boneLimits[0];
 
 		for (const auto& Outputs : RigDesc.Outputs)
 		{
 			if (Outputs.FloatCount == 7)
 			{
-				auto q = Pred.index({0, torch::indexing::Slice(Outputs.Offset + 3, Outputs.Offset + 7)});
-				res.QuaternionNormLoss = res.QuaternionNormLoss + torch::pow(torch::norm(q, 2) - 1.0f, 2);
+				auto q = Pred.index({torch::indexing::Slice(), torch::indexing::Slice(Outputs.Offset + 3, Outputs.Offset + 7)});
+				res.QuaternionNormLoss = res.QuaternionNormLoss + torch::pow(q.norm(2, -1) - 1.0f, 2).mean();
 			}
 		}
 
-		limitsLoss = limitsLoss * getWeight("Kinematics");
-		res.TotalLoss = res.TotalLoss + res.QuaternionNormLoss * getWeight("QuaternionNorm");
+		limitsLoss = limitsLoss * getWeight(NRLossSlot::Kinematics);
+		res.TotalLoss = res.TotalLoss + res.QuaternionNormLoss * getWeight(NRLossSlot::QuaternionNorm);
 
-		static int frameCounter = 0;
-		if (++frameCounter % 30 == 0)
+		if (Diag.ShouldSample())
 		{
-			std::cout << "--- Frame: " << frameCounter << " ---" << std::endl;
-			std::cout << "  PosLoss: " << res.PositionLoss.item<float>() << " * " << getWeight("Position") << std::endl;
-			std::cout << "  KinLoss: " << res.KinematicsLoss.item<float>() << " * " << getWeight("Kinematics") << std::endl;
-			std::cout << "  TempLoss: " << res.TemporalLoss.item<float>() << " * " << getWeight("Temporal") << std::endl;
-			std::cout << "  AccLoss: " << res.AccelerationLoss.item<float>() << " * " << getWeight("Acceleration") << std::endl;
-			std::cout << "  SmoothLoss: " << res.SmoothOutputLoss.item<float>() << " * " << getWeight("SmoothOutput") << std::endl;
-			std::cout << "  QuatLoss: " << res.QuaternionNormLoss.item<float>() << " * " << getWeight("QuaternionNorm") << std::endl;
-			std::cout << "  LimitLoss: " << limitsLoss.item<float>() << " * 20.0" << std::endl;
-			std::cout << "  Total: " << res.TotalLoss.item<float>() << std::endl;
-			std::cout << "-----------------------" << std::endl;
+			auto label = [&](const char* name, NRLossSlot slot) {
+				return std::string(name) + " * " + std::to_string(getWeight(slot));
+			};
+
+			Diag.Post("Loss", {{label("PosLoss", NRLossSlot::Position), res.PositionLoss},
+			                   {label("KinLoss", NRLossSlot::Kinematics), res.KinematicsLoss},
+			                   {label("TempLoss", NRLossSlot::Temporal), res.TemporalLoss},
+			                   {label("AccLoss", NRLossSlot::Acceleration), res.AccelerationLoss},
+			                   {label("SmoothLoss", NRLossSlot::SmoothOutput), res.SmoothOutputLoss},
+			                   {label("QuatLoss", NRLossSlot::QuaternionNorm), res.QuaternionNormLoss},
+			                   {"LimitLoss", limitsLoss},
+			                   {"Total", res.TotalLoss}});
 		}
 
 		return res;
@@ -285,149 +365,88 @@ namespace NR
 	template<FloatingPoint T>
 	torch::Tensor Trainee<T>::ComputeFK(const torch::Tensor& Pred, const torch::Tensor& Target)
 	{
-		const auto& SK = RigDesc.Skeleton;
-		auto totalLoss = torch::zeros({}, Pred.options());
-
-		auto quatToMat = [&](const torch::Tensor& q) -> torch::Tensor {
-			auto qn = q / (q.norm(2, 0) + 1e-8);
-
-			auto x = qn[0];
-			auto y = qn[1];
-			auto z = qn[2];
-			auto w = qn[3];
-
-			auto row1 = torch::stack({1 - 2 * y * y - 2 * z * z, 2 * x * y - 2 * w * z, 2 * x * z + 2 * w * y});
-			auto row2 = torch::stack({2 * x * y + 2 * w * z, 1 - 2 * x * x - 2 * z * z, 2 * y * z - 2 * w * x});
-			auto row3 = torch::stack({2 * x * z - 2 * w * y, 2 * y * z + 2 * w * x, 1 - 2 * x * x - 2 * y * y});
-
-			return torch::stack({row1, row2, row3});
-		};
-
-		auto pParent = Pred.index({0, torch::indexing::Slice(SK.Parent.Offset, SK.Parent.Offset + 3)});
-		auto qParent = Pred.index({0, torch::indexing::Slice(SK.Parent.Offset + 3, SK.Parent.Offset + 7)});
-		auto mParentPred = quatToMat(qParent);
-
-		auto pParentRest = Target.index({0, torch::indexing::Slice(SK.Parent.Offset, SK.Parent.Offset + 3)});
-		auto qParentRest = Target.index({0, torch::indexing::Slice(SK.Parent.Offset + 3, SK.Parent.Offset + 7)});
-		auto mParentRest = quatToMat(qParentRest);
-
-		const auto& TW = RigDesc.TrainingWeights;
-		float pFk = TW.LossWeights.at("Position").Weight;
-		float wFk = TW.LossWeights.at("Kinematics").Weight;
-		float wQuat = TW.LossWeights.at("QuaternionNorm").Weight;
-
-		auto pl0_loss = torch::mse_loss(pParent, pParentRest);
-		auto ml0_loss = torch::mse_loss(mParentPred, mParentRest);
-		totalLoss = totalLoss + (pl0_loss * pFk) + (ml0_loss * wFk);
-
-		for (size_t chainIdx = 0; chainIdx < SK.Rest.size(); ++chainIdx)
+		using torch::indexing::Slice;
+
+		const float pFk = Weights.Get(NRLossSlot::Position);
+		const float wFk = Weights.Get(NRLossSlot::Kinematics);
+		const float wQuat = Weights.Get(NRLossSlot::QuaternionNorm);
+
+		const auto& L = SkeletonLayout;
+		const int64_t numBones = L.NumBones();
+
+		// Whole skeleton in one pass: [B, NBones, ...]
+		auto pLocalAll = Kinematics::GatherPos(L, Pred);
+		auto qLocalAll = Kinematics::GatherQuat(L, Pred);
+		auto mLocalAll = Kinematics::QuatToMat(qLocalAll);
+		auto pTarget = Kinematics::GatherPos(L, Target);
+		auto qTarget = Kinematics::GatherQuat(L, Target);
+		auto pRest = L.RestPos.to(Pred.options());
+		auto mRest = Kinematics::QuatToMat(L.RestRot.to(Pred.options()));
+
+		// Parent (root) against the ideal target
+		auto pl0_loss = torch::mse_loss(pLocalAll.select(1, 0), pTarget.select(1, 0));
+		auto ml0_loss = torch::mse_loss(mLocalAll.select(1, 0), Kinematics::QuatToMat(qTarget.select(1, 0)));
+		auto totalLoss = (pl0_loss * pFk) + (ml0_loss * wFk);
+
+		if (numBones < 2)
 		{
-			auto pRest = SK.Parent.RestPose.Pos;
-			auto qRest = SK.Parent.RestPose.Rot;
-			auto mRest = quatToMat(qRest);
-
-			auto pChain = pParent;
-			auto mChain = mParentPred;
-			auto mAcc = pRest;
-			auto pAcc = mRest;
-
-			for (size_t boneIdx = 0; boneIdx < SK.Rest[chainIdx].size(); ++boneIdx)
-			{
-				const auto& bone = SK.Rest[chainIdx][boneIdx];
-
-				// Rest bones pose
-				auto pRest = bone.RestPose.Pos;
-				auto qRest = bone.RestPose.Rot;
-				auto mRest = quatToMat(qRest);
-
-				// Predicate bones pose
-				auto pLocal = Pred.index({0, torch::indexing::Slice(bone.Offset, bone.Offset + 3)});
-				auto qLocal = Pred.index({0, torch::indexing::Slice(bone.Offset + 3, bone.Offset + 7)});
-				auto mLocal = quatToMat(qLocal);
-
-				// pChain + mChain * pRest
-				auto pChild = pChain + torch::mv(mChain, pLocal);
-				auto mChild = torch::mm(mChain, mLocal);
-
-
-
-				//
-				auto anatomyPosLoss = torch::mse_loss(pLocal, pRest);
-				auto anatomyRotLoss = torch::mse_loss(mLocal, mRest);
-
-				std::cout << "================="<<bone.Name<<"=================" << std::endl;
-				std::cout << "pChain: " << pChain << " " << pChain.numel() << std::endl;
-				std::cout << "mChain: " << mChain << " " << mChain.numel() << std::endl;
-				std::cout << "=================Child=================" << std::endl;
-				std::cout << "pChild: " << pChild << " " << pChild.numel() << std::endl;
-				std::cout << "mChild: " << mChild << " " << mChild.numel() << std::endl;
-				std::cout << "=================Local=================" << std::endl;
-				std::cout << "pRest: " << pLocal << " " << pLocal.numel() << std::endl;
-				std::cout << "mRest: " << mLocal << " " << mLocal.numel() << std::endl;
-				std::cout << "=================Rest=================" << std::endl;
-				std::cout << "pRest: " << pRest << " " << pRest.numel() << std::endl;
-				std::cout << "mRest: " << mRest << " " << mRest.numel() << std::endl;
-
-				float bonePosMultiplier = 1.0f;
-				float boneRotMultiplier = 1.0f;
-				for (const auto& bias : TW.BoneSpecificBias)
-				{
-					if (bias.Name == bone.Name)
-					{
-						bonePosMultiplier = bias.PositionMultiplier;
-						boneRotMultiplier = bias.RotationMultiplier;
-						break;
-					}
-				}
+			return totalLoss;
+		}
 
-				auto predLength = torch::norm(pLocal, 2);
-				auto restLength = torch::norm(pRest, 2);
+		// Chain bones, every term below is a [NBones - 1] vector
+		const auto chain = Slice(1, torch::indexing::None);
+		auto pLocal = pLocalAll.index({Slice(), chain});
+		auto qLocal = qLocalAll.index({Slice(), chain});
+		auto mLocal = mLocalAll.index({Slice(), chain});
+		auto bonePosMultiplier = Weights.BonePosition.to(Pred.options()).index({chain});
+		auto boneRotMultiplier = Weights.BoneRotation.to(Pred.options()).index({chain});
 
-				// Penalty for bone length
-				auto boneLengthLoss = torch::pow(predLength - restLength, 2) * bonePosMultiplier;
+		auto anatomyPosLoss = (pLocal - pRest.index({chain})).pow(2).mean({0, 2});
+		auto anatomyRotLoss = (mLocal - mRest.index({chain})).pow(2).mean({0, 2, 3});
 
-				// Penalty for quaternion normalization
-				auto qLocalNorm = torch::norm(qLocal, 2);
-				auto quatNormLoss = torch::pow(qLocalNorm - 1.0f, 2) * wQuat;
+		// Penalty for quaternion normalization
+		auto quatNormLoss = (qLocal.norm(2, -1) - 1.0f).pow(2).mean(0) * wQuat;
 
-				auto rotMagnitude = torch::sum(torch::pow(qLocal.index({torch::indexing::Slice(0, 3)}), 2));
-				auto rotLoss = torch::clamp(rotMagnitude - 0.5f, 0.0f) * wQuat;
+		auto rotMagnitude = qLocal.index({"...", Slice(0, 3)}).pow(2).sum(-1);
+		auto rotLoss = torch::clamp(rotMagnitude - 0.5f, 0.0f).mean(0) * wQuat;
 
-				totalLoss = totalLoss + quatNormLoss + boneLengthLoss + rotLoss;
+		// Weights switch on the anatomy error without reading it back to the host
+		auto anatomy = anatomyPosLoss.detach();
+		auto rIkWeight = torch::where(anatomy > 0.05f, boneRotMultiplier * wFk, 0.001f);
+		auto pIkWeight = torch::where(anatomy > 0.05f, bonePosMultiplier * pFk, 0.001f);
+		auto pTargetWeight = torch::where(anatomy < 0.05f, pFk, 0.001f).to(Pred.options());
 
-				auto ikLoss = torch::zeros({}, Pred.options());
-				if (boneIdx == SK.Rest[chainIdx].size() - 1)
-				{
-					auto pTarget = Target.index({0, torch::indexing::Slice(bone.Offset, bone.Offset + 3)});
-					ikLoss = torch::mse_loss(pChild, pTarget);
-				}
+		// Bone length and end effector IK terms go through the fused chain operator
+		auto rootWeight = torch::zeros({1}, Pred.options());
+		auto lengthWeight = torch::cat({rootWeight, bonePosMultiplier});
+		auto ikWeight = torch::cat({rootWeight, pTargetWeight * L.EndMask.to(Pred.options()).index({chain})});
+		auto chainLoss = Kinematics::ChainLoss(L, pLocalAll, qLocalAll, pTarget, lengthWeight, ikWeight);
 
-				float pTargetWeight = (anatomyPosLoss.item<float>() < 0.05f) ? pFk : 0.001f;
-				float rIkWeight = (anatomyPosLoss.item<float>() > 0.05f) ? wFk * boneRotMultiplier : 0.001f;
-				float pIkWeight = (anatomyPosLoss.item<float>() > 0.05f) ? pFk * bonePosMultiplier : 0.001f;
-				totalLoss = totalLoss + (anatomyPosLoss * pIkWeight) + (anatomyRotLoss * rIkWeight) + (ikLoss * pTargetWeight);
+		auto boneLoss = quatNormLoss + rotLoss + (anatomyPosLoss * pIkWeight) + (anatomyRotLoss * rIkWeight);
 
-				pChain = pChild;
-				mChain = mChild;
-				mAcc = mAcc + mChild;
-				pAcc = pAcc + pChild;
-			}
-		}
-
-		return totalLoss;
+		return totalLoss + boneLoss.sum() + chainLoss;
 	}
 
 
 	template<FloatingPoint T>
 	void Trainee<T>::SaveWeights(const std::string& Path)
 	{
-		torch::save(TargetModel, Path);
+		Checkpointer::Write(Checkpointer::Capture(*TargetModel, *Optimizer, Path), 0);
+	}
+
+	template<FloatingPoint T>
+	void Trainee<T>::SaveCheckpointAsync(const std::string& Path)
+	{
+		Checkpoints.Save(*TargetModel, *Optimizer, Path);
 	}
 
 	template<FloatingPoint T>
 	void Trainee<T>::LoadWeights(const std::string& Path)
 	{
-		torch::load(TargetModel, Path);
+		if (!Checkpointer::Load(*TargetModel, Optimizer.get(), Path))
+		{
+			std::cout << "[Trainee] No optimizer state in " << Path << ", starting with fresh moments." << std::endl;
+		}
 		TargetModel->train();
 	}
 
@@ -461,6 +480,16 @@ namespace NR
 	}
 
 
+	template<FloatingPoint T>
+	void Trainee<T>::ClearHistory()
+	{
+		PredHistory = torch::Tensor();
+		PredHistory2 = torch::Tensor();
+		SmoothedOutput = torch::Tensor();
+		PredictionCandidates.clear();
+	}
+
+
 	template class Trainee<float>;
 	template class Trainee<double>;
 } // namespace NR
@@ -0,0 +1,142 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace NR
+{
+	/**
+	 * @brief Fixed-capacity multi-producer / multi-consumer queue.
+	 *
+	 * Push blocks while the queue is full and Pop blocks while it is empty. After
+	 * Close(), pushes fail and pops drain the remaining items before returning nullopt.
+	 */
+	template<typename TItem>
+	class BoundedQueue
+	{
+	public:
+		explicit BoundedQueue(size_t InCapacity)
+			: Capacity(InCapacity > 0 ? InCapacity : 1)
+		{
+		}
+
+		bool Push(TItem Item)
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			NotFull.wait(lock, [this] { return bClosed || bNoWait || Items.size() < Capacity; });
+			if (bClosed || Items.size() >= Capacity)
+			{
+				return false;
+			}
+
+			Items.push_back(std::move(Item));
+			lock.unlock();
+			NotEmpty.notify_one();
+			return true;
+		}
+
+		bool TryPush(TItem Item)
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			if (bClosed || Items.size() >= Capacity)
+			{
+				return false;
+			}
+
+			Items.push_back(std::move(Item));
+			lock.unlock();
+			NotEmpty.notify_one();
+			return true;
+		}
+
+		std::optional<TItem> Pop()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			NotEmpty.wait(lock, [this] { return bClosed || !Items.empty(); });
+			return TakeFront(lock);
+		}
+
+		std::optional<TItem> TryPop()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			return TakeFront(lock);
+		}
+
+		void Close()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				bClosed = true;
+			}
+			NotEmpty.notify_all();
+			NotFull.notify_all();
+		}
+
+		/**
+		 * @brief Wakes blocked pushers; from now on Push fails instead of waiting on a full queue.
+		 *
+		 * Pushes that find room still succeed and pops are unaffected, so a producer can be
+		 * released before it is joined without closing the queue to its consumer.
+		 */
+		void StopWaiting()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				bNoWait = true;
+			}
+			NotFull.notify_all();
+		}
+
+		[[nodiscard]] bool IsClosed() const
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			return bClosed;
+		}
+
+		[[nodiscard]] size_t Size() const
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			return Items.size();
+		}
+
+	private:
+		std::optional<TItem> TakeFront(std::unique_lock<std::mutex>& Lock)
+		{
+			if (Items.empty())
+			{
+				return std::nullopt;
+			}
+
+			std::optional<TItem> item(std::move(Items.front()));
+			Items.pop_front();
+			Lock.unlock();
+			NotFull.notify_one();
+			return item;
+		}
+
+		const size_t Capacity;
+		mutable std::mutex Mutex;
+		std::condition_variable NotEmpty;
+		std::condition_variable NotFull;
+		std::deque<TItem> Items;
+		bool bClosed = false;
+		bool bNoWait = false; // See StopWaiting
+	};
+} // namespace NR
@@ -0,0 +1,95 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Rules.h"
+
+namespace NR
+{
+	/**
+	 * @brief Evaluates the compiled rules of every binding over a whole batch at once.
+	 *
+	 * Each rule variable is bound to a column of Batch doubles and every expression runs
+	 * through muParser's bulk mode, one call per expression instead of one per sample.
+	 * The phase of each row is picked with a mask (first true condition wins), matching
+	 * the scalar path.
+	 *
+	 * The gait clock stays sequential: t_cycle is accumulated row by row and wrapped by
+	 * the T_gait of the previous row, like Rules::SetInputs does frame by frame.
+	 * This assumes T_gait only depends on constants, inputs and earlier Logic terms, not
+	 * on t_cycle. After a call, the scalar state of Rules matches the last row, so the
+	 * scalar and bulk paths can be mixed.
+	 *
+	 * With Rules::EnableGaitTables, rows the table of a rule covers are read from it and
+	 * the others fall back to the phases, like the scalar path does frame by frame.
+	 */
+	class BulkEvaluator
+	{
+	public:
+		/**
+		 * @param Source Rules already set up for every binding of Profile
+		 * @param Profile Model profile
+		 */
+		BulkEvaluator(Rules& Source, const NRModelProfile& Profile);
+
+		/**
+		 * @brief Evaluates the targets of a batch.
+		 * @param Inputs Input frames [Batch, InputSize]
+		 * @param Out Target rows [Batch, OutCount], written at each binding offset
+		 * @param OutCount Number of floats per target row
+		 */
+		void Evaluate(const torch::Tensor& Inputs, float* Out, int64_t OutCount);
+
+	private:
+		struct BindingState
+		{
+			int Offset = 0;
+			std::vector<std::string> Names;             // Every variable of the binding
+			std::vector<double*> Scalars;               // Matching slots in Rules::Vars
+			std::unordered_map<const double*, size_t> ColumnOfSlot;
+			std::vector<std::vector<double>> Columns;   // Matching bulk columns
+			std::vector<std::pair<size_t, int64_t>> InputColumns; // Column, input offset
+			std::vector<mu::Parser> Parsers;            // Bulk parser per compiled expression
+			std::unordered_map<ExprHandle, size_t> ParserIndex;
+
+			// Variables bound to t_cycle, in the order Rules::SetInputs visits them
+			struct ClockRead
+			{
+				size_t Column = 0;
+				ExprHandle TGait = InvalidExpr; // Clock is not wrapped (nor written) without T_gait
+				size_t TGaitColumn = 0;
+			};
+			std::vector<ClockRead> ClockReads;
+		};
+
+		void Reserve(int64_t Rows);
+		void EvalColumn(BindingState& State, ExprHandle Handle, double* Result, int64_t Rows);
+
+		/**
+		 * @brief Writes the rows a gait table covers and marks them in Chosen.
+		 * @return Number of rows written
+		 */
+		int64_t LookupGaitTable(const BindingState& State, const Rules::CompiledRule::TableState& Tabulated, int64_t Rows,
+		                        float* Out, int64_t OutCount, std::vector<int32_t>& Chosen);
+
+		Rules& Source;
+		std::vector<BindingState> Bindings;
+		int64_t TCycleInput = -1;
+		int64_t Capacity = 0;
+		std::vector<double> Scratch;
+		std::vector<double> ClockInput;
+	};
+} // namespace NR
@@ -0,0 +1,47 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Kinematics.h"
+#include "Core/Rules.h"
+#include "Core/Types.h"
+#include "Core/WeightPlan.h"
+
+namespace NR
+{
+	/**
+	 * @brief Everything a Trainee or a solver derives from a profile, ready to be swapped in.
+	 */
+	struct NRCompiledProfile
+	{
+		NRModelProfile Profile;
+		Rules Evaluator;             // Set up for every binding of Profile
+		NRKinematicLayout Layout;
+		NRWeightPlan Weights;
+
+		/**
+		 * @brief Builds the rule evaluator, skeleton layout and weight plan of a profile.
+		 * @param Profile Profile with skeleton and training weights loaded
+		 * @param Base Rules the evaluator is copied from (keeps options such as gait tables)
+		 */
+		static NRCompiledProfile Compile(NRModelProfile Profile, const Rules& Base);
+
+		/**
+		 * @brief Same input and output blocks, so a model trained on A can keep running on B.
+		 */
+		static bool SameLayout(const NRModelProfile& A, const NRModelProfile& B);
+	};
+} // namespace NR
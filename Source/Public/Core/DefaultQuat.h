@@ -0,0 +1,40 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Interfaces/IQuat.h"
+
+namespace NR
+{
+	/**
+	 * @brief Built-in vectorized quaternion converter.
+	 *
+	 * Rotations are applied in yaw (Z), pitch (Y), roll (X) order, q = qYaw * qPitch * qRoll,
+	 * with angles stored as [pitch, yaw, roll] in radians and quaternions as [x, y, z, w].
+	 * Every conversion is a handful of tensor ops over the whole batch and is differentiable.
+	 */
+	class DefaultQuat : public IQuat
+	{
+	public:
+		[[nodiscard]] Quat ToQuat(float pitch, float yaw, float roll) const override;
+
+		Vec3 ToEuler(const Quat& q) const override;
+
+		Quat ToQuatBatch(const Vec3& Euler) const override;
+
+		Vec3 ToEulerBatch(const Quat& Q) const override;
+	};
+} // namespace NR
@@ -0,0 +1,94 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace NR
+{
+	/**
+	 * @brief Opt-in, rate-limited logging sink for training diagnostics.
+	 *
+	 * The hot path only counts frames and, when a sample is due, hands detached
+	 * copies of the tensors to a worker thread. Reading values back and writing
+	 * to stdout happen on that worker, so the training thread never blocks on it.
+	 * When the worker falls behind, new entries are dropped instead of queued.
+	 */
+	class Diagnostics
+	{
+	public:
+		using ValueList = std::vector<std::pair<std::string, torch::Tensor>>;
+
+		Diagnostics() = default;
+		~Diagnostics();
+
+		Diagnostics(const Diagnostics&) = delete;
+		Diagnostics& operator=(const Diagnostics&) = delete;
+
+		/**
+		 * @brief Starts sampling diagnostics.
+		 * @param Interval Number of frames between two samples
+		 */
+		void Enable(int32_t Interval = 30);
+
+		/**
+		 * @brief Stops sampling and flushes the entries already queued.
+		 */
+		void Disable();
+
+		[[nodiscard]] bool IsEnabled() const { return bEnabled.load(std::memory_order_relaxed); }
+
+		/**
+		 * @brief Advances the frame counter.
+		 * @return true when diagnostics are enabled and a sample is due this frame
+		 */
+		bool ShouldSample();
+
+		/**
+		 * @brief Queues a group of values to be printed by the worker thread.
+		 * @param Title Header printed before the values
+		 * @param Values Named tensors, detached and copied before being queued
+		 */
+		void Post(const std::string& Title, const ValueList& Values);
+
+	private:
+		struct Entry
+		{
+			std::string Title;
+			uint64_t Frame = 0;
+			ValueList Values;
+		};
+
+		static constexpr size_t MaxPending = 8;
+
+		void Run();
+
+		std::atomic<bool> bEnabled{false};
+		std::atomic<int32_t> SampleInterval{30};
+		uint64_t FrameCounter = 0;
+
+		std::mutex Mutex;
+		std::condition_variable Signal;
+		std::deque<Entry> Pending;
+		bool bStopping = false;
+		std::thread Worker;
+	};
+} // namespace NR
@@ -0,0 +1,83 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief Calls back from a background thread when one of a set of files changes.
+	 *
+	 * On Linux the parent directories are watched with inotify, so files replaced by
+	 * a rename (how most editors save) are seen as well. Elsewhere the modification
+	 * times are polled. Bursts of events are merged: the callback runs once the files
+	 * have been quiet for the debounce delay.
+	 */
+	class FileWatcher
+	{
+	public:
+		using Callback = std::function<void()>;
+
+		/**
+		 * @param InPaths Files to watch
+		 * @param InOnChange Called on the watcher thread
+		 * @param InDebounce Quiet time required after the last change
+		 */
+		FileWatcher(std::vector<std::string> InPaths, Callback InOnChange,
+		            std::chrono::milliseconds InDebounce = std::chrono::milliseconds(250));
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		/**
+		 * @brief Starts the watcher thread.
+		 * @return false if the files could not be watched
+		 */
+		bool Start();
+
+		/**
+		 * @brief Stops and joins the watcher thread. Safe to call more than once.
+		 */
+		void Stop();
+
+		[[nodiscard]] bool IsRunning() const { return bRunning; }
+
+	private:
+		void RunNotify();
+		void RunPolling();
+
+		/**
+		 * @return Latest modification time of each file, in Paths order
+		 */
+		std::vector<std::filesystem::file_time_type> Snapshot() const;
+
+		std::vector<std::string> Paths;
+		Callback OnChange;
+		std::chrono::milliseconds Debounce;
+
+		std::thread Worker;
+		std::atomic<bool> bRunning{false};
+		int NotifyFd = -1;
+	};
+} // namespace NR
@@ -0,0 +1,94 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief Grid and accuracy of the gait tables built by Rules::EnableGaitTables.
+	 */
+	struct NRGaitTableOptions
+	{
+		std::string PhaseVariable = "phase_offset"; // Logic term used as the phase axis
+		std::string VelocityVariable = "velocity";  // Input variable used as the velocity axis
+
+		// Odd count keeps phase 0.5 (stance/swing switch) on a grid node
+		double PhaseMin = 0.0;
+		double PhaseMax = 1.0;
+		int32_t PhaseSamples = 257;
+
+		double VelocityMin = 0.5;
+		double VelocityMax = 8.0;
+		int32_t VelocitySamples = 64;
+
+		double Tolerance = 1e-3;     // Max absolute error against the exact formulas
+		int32_t CheckSamples = 1024; // Random points compared when the table is built
+	};
+
+	/**
+	 * @brief Phase outputs of a rule sampled on a regular phase × velocity grid.
+	 *
+	 * Values are stored as [Phase][Velocity][Output], so the four corners of a cell are
+	 * contiguous runs of Outputs floats and the bilinear blend is a straight loop.
+	 */
+	class GaitTable
+	{
+	public:
+		GaitTable(double PhaseMin, double PhaseMax, int32_t PhaseSamples,
+		          double VelocityMin, double VelocityMax, int32_t VelocitySamples, int32_t Outputs);
+
+		/**
+		 * @return Outputs of the grid point (PhaseIndex, VelocityIndex)
+		 */
+		float* Cell(int32_t PhaseIndex, int32_t VelocityIndex);
+
+		[[nodiscard]] double PhaseAt(int32_t Index) const { return PhaseMin + Index * PhaseStep; }
+		[[nodiscard]] double VelocityAt(int32_t Index) const { return VelocityMin + Index * VelocityStep; }
+
+		/**
+		 * @brief Bilinear interpolation of every output.
+		 * @param Phase Phase, within [PhaseMin, PhaseMax]
+		 * @param Velocity Velocity, within [VelocityMin, VelocityMax]
+		 * @param Out Receives Outputs values
+		 * @return false when the point is outside the grid (or NaN)
+		 */
+		bool Lookup(double Phase, double Velocity, float* Out) const;
+
+		[[nodiscard]] int32_t GetOutputs() const { return Outputs; }
+		[[nodiscard]] int32_t GetPhaseSamples() const { return PhaseSamples; }
+		[[nodiscard]] int32_t GetVelocitySamples() const { return VelocitySamples; }
+
+		double MaxError = 0.0; // Measured against the exact formulas when built
+
+	private:
+		double PhaseMin;
+		double PhaseMax;
+		double PhaseStep;
+		int32_t PhaseSamples;
+
+		double VelocityMin;
+		double VelocityMax;
+		double VelocityStep;
+		int32_t VelocitySamples;
+
+		int32_t Outputs;
+		std::vector<float> Values;
+	};
+} // namespace NR
@@ -0,0 +1,188 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+
+namespace NR
+{
+	/**
+	 * @brief FK and bone constraint kernels compiled for one known skeleton topology.
+	 *
+	 * Poses are flat rows of Stride floats with the bone blocks at the layout Offsets.
+	 * Global outputs are [Batch, NBones, 3] positions and [Batch, NBones, 3, 3] rotations.
+	 */
+	struct NRFixedKernel
+	{
+		const char* Name = "";
+		std::vector<int64_t> Parents; // Topology the kernel was compiled for
+		void (*Forward)(const float* Pose, int64_t Batch, int64_t Stride, const int64_t* Offsets, float* GlobalPos, float* GlobalRot) = nullptr;
+		void (*Constrain)(float* Pose, int64_t Batch, int64_t Stride, const int64_t* Offsets, const float* RestLength) = nullptr;
+	};
+
+	/**
+	 * @brief Flattened view of an NRSkeleton used by the batched forward kinematics.
+	 *
+	 * Structure-of-arrays form of the skeleton, built once per profile. Bone 0 is the
+	 * skeleton Parent. A chain hangs off the bone whose ChildrenIndices lists it (the
+	 * Parent when no bone does), so any tree of chains is supported. Chains are laid
+	 * out breadth-first, which keeps parents before their children and lets bones be
+	 * composed level by level in a single forward sweep.
+	 */
+	struct NRKinematicLayout
+	{
+		std::vector<std::string> Names;
+		std::vector<int64_t> Parents;      // -1 for the root
+		std::vector<int64_t> Offsets;      // Output offset of each vec3|Quat block
+		std::vector<int64_t> EndEffectors; // Last bone of each chain
+
+		torch::Tensor PosIndex;    // [NBones * 3] output columns of the local positions
+		torch::Tensor RotIndex;    // [NBones * 4] output columns of the local quaternions
+		torch::Tensor EndIndex;    // [NEnd]
+		torch::Tensor EndMask;     // [NBones] 1 for end effectors, 0 otherwise
+		torch::Tensor ParentIndex; // [NBones]
+		torch::Tensor RestPos;     // [NBones, 3]
+		torch::Tensor RestRot;     // [NBones, 4]
+		torch::Tensor RestLength;  // [NBones]
+		torch::Tensor LimitMin;    // [NBones, 3] Euler limits in radians, -inf when unset
+		torch::Tensor LimitMax;    // [NBones, 3] Euler limits in radians, +inf when unset
+
+		// Bones grouped by depth (depth >= 1) and their matching parents
+		std::vector<torch::Tensor> LevelBones;
+		std::vector<torch::Tensor> LevelParents;
+
+		// Specialized kernels of a known topology, nullptr when the generic ones are used
+		const NRFixedKernel* Fixed = nullptr;
+
+		[[nodiscard]] int64_t NumBones() const { return static_cast<int64_t>(Names.size()); }
+	};
+
+	/**
+	 * @brief Local and global transforms of every bone for a batch of poses.
+	 */
+	struct NRFKResult
+	{
+		torch::Tensor LocalPos;  // [B, NBones, 3]
+		torch::Tensor LocalQuat; // [B, NBones, 4]
+		torch::Tensor LocalRot;  // [B, NBones, 3, 3]
+		torch::Tensor GlobalPos; // [B, NBones, 3]
+		torch::Tensor GlobalRot; // [B, NBones, 3, 3]
+	};
+
+	class Kinematics
+	{
+	public:
+		/**
+		 * @brief Builds the flattened bone layout of a skeleton.
+		 * @param Skeleton Skeleton loaded from the SK profile
+		 * @return Layout with parent indices, output offsets and rest pose tensors
+		 */
+		static NRKinematicLayout BuildLayout(const NRSkeleton& Skeleton);
+
+		/**
+		 * @brief Looks up the kernels compiled for a topology.
+		 * @param Parents Parent index of every bone, as in NRKinematicLayout
+		 * @return Matching kernels, nullptr when the topology is not a known one
+		 */
+		static const NRFixedKernel* FindFixedKernel(const std::vector<int64_t>& Parents);
+
+		/**
+		 * @brief Forward kinematics on raw CPU buffers, without autograd.
+		 *
+		 * Runs the layout's fixed kernel when it has one and the generic loop otherwise;
+		 * both give the global transforms of Forward.
+		 * @param Layout Skeleton layout
+		 * @param Pose Batch rows of Stride floats
+		 * @param GlobalPos Receives [Batch, NBones, 3]
+		 * @param GlobalRot Receives [Batch, NBones, 3, 3]
+		 */
+		static void ForwardPose(const NRKinematicLayout& Layout, const float* Pose, int64_t Batch, int64_t Stride, float* GlobalPos, float* GlobalRot);
+
+		/**
+		 * @brief Enforces the bone constraints on raw CPU poses in place.
+		 *
+		 * Quaternions are normalized and the local position of every non-root bone is
+		 * rescaled to its rest length. Dispatches like ForwardPose.
+		 * @param Layout Skeleton layout
+		 * @param Pose Batch rows of Stride floats
+		 */
+		static void ConstrainPose(const NRKinematicLayout& Layout, float* Pose, int64_t Batch, int64_t Stride);
+
+		/**
+		 * @brief Converts quaternions [x, y, z, w] to rotation matrices.
+		 * @param Q Tensor of shape [..., 4]; quaternions are normalized first
+		 * @return Tensor of shape [..., 3, 3]
+		 */
+		static torch::Tensor QuatToMat(const torch::Tensor& Q);
+
+		/**
+		 * @brief Extracts the local position of every bone from a flat pose tensor.
+		 * @param Layout Skeleton layout
+		 * @param Pose Tensor of shape [B, OutputSize] or [OutputSize]
+		 * @return Tensor of shape [B, NBones, 3]
+		 */
+		static torch::Tensor GatherPos(const NRKinematicLayout& Layout, const torch::Tensor& Pose);
+
+		/**
+		 * @brief Extracts the local quaternion of every bone from a flat pose tensor.
+		 * @param Layout Skeleton layout
+		 * @param Pose Tensor of shape [B, OutputSize] or [OutputSize]
+		 * @return Tensor of shape [B, NBones, 4]
+		 */
+		static torch::Tensor GatherQuat(const NRKinematicLayout& Layout, const torch::Tensor& Pose);
+
+		/**
+		 * @brief Composes local transforms into global transforms along the hierarchy.
+		 * @param Layout Skeleton layout
+		 * @param LocalPos Tensor of shape [B, NBones, 3]
+		 * @param LocalRot Tensor of shape [B, NBones, 3, 3]
+		 * @param OutPos Receives the global positions [B, NBones, 3]
+		 * @param OutRot Receives the global rotations [B, NBones, 3, 3]
+		 */
+		static void Compose(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalRot, torch::Tensor& OutPos, torch::Tensor& OutRot);
+
+		/**
+		 * @brief Runs forward kinematics over the whole skeleton for a batch of poses.
+		 * @param Layout Skeleton layout
+		 * @param Pose Network output of shape [B, OutputSize] or [OutputSize]
+		 * @return Local and global transforms of every bone
+		 */
+		static NRFKResult Forward(const NRKinematicLayout& Layout, const torch::Tensor& Pose);
+
+		/**
+		 * @brief Fused FK chain loss with a hand-derived backward pass (CPU).
+		 *
+		 * Computes sum_i LengthWeight_i * mean((|p_i| - RestLength_i)^2)
+		 *        + sum_i IKWeight_i * mean((P_i - TargetPos_i)^2)
+		 * where p_i is the local and P_i the global position of bone i. The whole chain is
+		 * recorded as a single autograd node. Tensors on other devices fall back to
+		 * ChainLossReference.
+		 * @param Layout Skeleton layout
+		 * @param LocalPos Tensor of shape [B, NBones, 3]
+		 * @param LocalQuat Tensor of shape [B, NBones, 4]
+		 * @param TargetPos Tensor of shape [B, NBones, 3], treated as a constant
+		 * @param LengthWeight Tensor of shape [NBones], treated as a constant
+		 * @param IKWeight Tensor of shape [NBones], treated as a constant
+		 * @return Scalar loss tensor
+		 */
+		static torch::Tensor ChainLoss(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalQuat, const torch::Tensor& TargetPos, const torch::Tensor& LengthWeight, const torch::Tensor& IKWeight);
+
+		/**
+		 * @brief Same loss as ChainLoss, built from regular autograd ops over Compose.
+		 */
+		static torch::Tensor ChainLossReference(const NRKinematicLayout& Layout, const torch::Tensor& LocalPos, const torch::Tensor& LocalQuat, const torch::Tensor& TargetPos, const torch::Tensor& LengthWeight, const torch::Tensor& IKWeight);
+	};
+} // namespace NR
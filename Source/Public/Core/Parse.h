@@ -33,5 +33,22 @@ namespace NR
 		static bool LoadIKFromJson(const std::string& FilePath, NRModelProfile& OutProfile);
 		static bool LoadSKFromJson(const std::string& FilePath, NRSkeleton& OutSkeleton, IQuat* OutQuat);
 		static bool LoadTWFromJson(const std::string& FilePath, NRTrainingWeights& OutWeights);
+
+		/**
+		 * @brief Loads IK, SK and TW through a compiled binary cache.
+		 *
+		 * When CachePath holds a profile compiled from the same file contents (and the same
+		 * quaternion converter) it is read directly. Otherwise the JSON files are parsed and
+		 * the cache is rewritten.
+		 * @param IKPath Rules and schema (IK.json)
+		 * @param SKPath Skeleton (SK.json)
+		 * @param TWPath Training weights (TW.json)
+		 * @param CachePath Compiled profile (.nrpc)
+		 * @param OutProfile Reference to the profile structure to be populated
+		 * @param OutQuat Converter for the rest rotations, see LoadSKFromJson
+		 * @return true if successful, false otherwise
+		 */
+		static bool LoadProfileCached(const std::string& IKPath, const std::string& SKPath, const std::string& TWPath,
+		                              const std::string& CachePath, NRModelProfile& OutProfile, IQuat* OutQuat);
 	};
 } // namespace NR
@@ -0,0 +1,80 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+
+namespace NR
+{
+	/**
+	 * @brief On-disk header of a compiled profile (.nrpc).
+	 *
+	 * Followed by PayloadSize bytes holding the inputs, outputs, parameter tables,
+	 * bindings with their rules, the skeleton and the training weights, in that order.
+	 * Rules refer to their parameter table by id. Numbers are stored in the native
+	 * byte order of the machine that wrote the file, and a file from a machine of the
+	 * other byte order is rejected (its Magic reads as SwappedMagicValue). Strings and
+	 * arrays are prefixed by a uint32 count; tensors keep float32 or float64.
+	 */
+	struct NRProfileCacheHeader
+	{
+		static constexpr uint32_t MagicValue = 0x4350524E;        // "NRPC"
+		static constexpr uint32_t SwappedMagicValue = 0x4E525043; // MagicValue read with the other byte order
+		static constexpr uint32_t CurrentVersion = 3;
+
+		uint32_t Magic = MagicValue;
+		uint32_t Version = CurrentVersion;
+		uint64_t SourceHash = 0;  // Hash of the JSON files the profile was compiled from
+		uint64_t PayloadSize = 0;
+		uint64_t PayloadHash = 0; // Detects truncated or corrupted files
+	};
+
+	/**
+	 * @brief Binary snapshot of a fully loaded NRModelProfile.
+	 *
+	 * The JSON files remain the source of truth: the cache records the hash of their
+	 * contents and is rejected as soon as one of them changes. See Parse::LoadProfileCached.
+	 */
+	class ProfileCache
+	{
+	public:
+		/**
+		 * @brief FNV-1a hash of the contents of every file, in order.
+		 * @param Paths Source files
+		 * @param Salt Anything else the compiled result depends on (the IQuat converter)
+		 * @return 0 if a file cannot be read
+		 */
+		static uint64_t HashFiles(const std::vector<std::string>& Paths, const std::string& Salt = {});
+
+		/**
+		 * @brief Writes a compiled profile.
+		 * @param Path Destination file, replaced atomically
+		 * @param Profile Profile with skeleton and training weights loaded
+		 * @param SourceHash Hash of the sources, see HashFiles
+		 * @return true if successful, false otherwise
+		 */
+		static bool Write(const std::string& Path, const NRModelProfile& Profile, uint64_t SourceHash);
+
+		/**
+		 * @brief Reads a compiled profile.
+		 * @param Path File written by Write
+		 * @param ExpectedHash Hash of the current sources
+		 * @param OutProfile Profile to fill, only modified on success
+		 * @return false if the file is missing, stale, from another version or damaged
+		 */
+		static bool Read(const std::string& Path, uint64_t ExpectedHash, NRModelProfile& OutProfile);
+	};
+} // namespace NR
@@ -0,0 +1,145 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief Block resolved once by name. Input and output handles are distinct types.
+	 */
+	template<typename Tag>
+	struct NRBlockHandle
+	{
+		int32_t Index = -1;
+
+		[[nodiscard]] bool IsValid() const { return Index >= 0; }
+	};
+
+	using NRInputHandle = NRBlockHandle<struct NRInputTag>;
+	using NROutputHandle = NRBlockHandle<struct NROutputTag>;
+
+	struct NRVec3f
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+	};
+
+	struct NRQuatf
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+		float W = 1.0f;
+	};
+
+	/**
+	 * @brief Floats of one block inside a frame buffer, without copying them.
+	 *
+	 * Bone blocks are laid out as position (3) followed by rotation (4); 4-float blocks
+	 * hold a rotation only.
+	 */
+	struct NRBlockView
+	{
+		const float* Data = nullptr;
+		int32_t Count = 0;
+
+		[[nodiscard]] bool IsValid() const { return Data != nullptr; }
+
+		/**
+		 * @return Position of a vec3 or vec3|Quat block, zero otherwise
+		 */
+		[[nodiscard]] NRVec3f Position() const
+		{
+			return Count == 3 || Count == 7 ? NRVec3f{Data[0], Data[1], Data[2]} : NRVec3f{};
+		}
+
+		/**
+		 * @return Rotation [x, y, z, w] of a Quat or vec3|Quat block, identity otherwise
+		 */
+		[[nodiscard]] NRQuatf Rotation() const
+		{
+			const int32_t first = Count == 7 ? 3 : 0;
+			return Count == 4 || Count == 7 ? NRQuatf{Data[first], Data[first + 1], Data[first + 2], Data[first + 3]} : NRQuatf{};
+		}
+	};
+
+	/**
+	 * @brief Precomputed accessors of an NRModelProfile's input and output layout.
+	 *
+	 * Names are resolved to handles once, totals are summed once, and frames are read
+	 * through views over the caller's buffer. The view copies the blocks it needs, so it
+	 * stays valid when the profile is moved; rebuild it when the profile changes.
+	 */
+	class NRProfileView
+	{
+	public:
+		NRProfileView() = default;
+		explicit NRProfileView(const NRModelProfile& Profile);
+
+		[[nodiscard]] NRInputHandle FindInput(const std::string& Name) const;
+		[[nodiscard]] NROutputHandle FindOutput(const std::string& Name) const;
+
+		[[nodiscard]] int32_t GetInputSize() const { return InputSize; }
+		[[nodiscard]] int32_t GetOutputSize() const { return OutputSize; }
+
+		[[nodiscard]] const NRDataBlock& GetBlock(NRInputHandle Handle) const { return Inputs[Handle.Index]; }
+		[[nodiscard]] const NRDataBlock& GetBlock(NROutputHandle Handle) const { return Outputs[Handle.Index]; }
+
+		/**
+		 * @param Frame One input row of GetInputSize() floats
+		 */
+		[[nodiscard]] NRBlockView View(const float* Frame, NRInputHandle Handle) const
+		{
+			return Handle.IsValid() ? NRBlockView{Frame + Inputs[Handle.Index].Offset, Inputs[Handle.Index].FloatCount} : NRBlockView{};
+		}
+
+		/**
+		 * @param Frame One output row of GetOutputSize() floats
+		 */
+		[[nodiscard]] NRBlockView View(const float* Frame, NROutputHandle Handle) const
+		{
+			return Handle.IsValid() ? NRBlockView{Frame + Outputs[Handle.Index].Offset, Outputs[Handle.Index].FloatCount} : NRBlockView{};
+		}
+
+		/**
+		 * @brief Same as NRModelProfile::GetInputBoneValue, without the name lookup.
+		 * @param Input Tensor [B, InputSize] or [InputSize]
+		 */
+		[[nodiscard]] torch::Tensor Slice(const torch::Tensor& Input, NRInputHandle Handle) const;
+
+		/**
+		 * @brief Same as NRModelProfile::GetOutputBoneValue, without the name lookup.
+		 * @param Output Tensor [B, OutputSize] or [OutputSize]
+		 */
+		[[nodiscard]] torch::Tensor Slice(const torch::Tensor& Output, NROutputHandle Handle) const;
+
+	private:
+		static torch::Tensor SliceBlock(const torch::Tensor& Data, const NRDataBlock& Block);
+
+		std::vector<NRDataBlock> Inputs;
+		std::vector<NRDataBlock> Outputs;
+		std::unordered_map<std::string, int32_t> InputIndex;
+		std::unordered_map<std::string, int32_t> OutputIndex;
+		int32_t InputSize = 0;
+		int32_t OutputSize = 0;
+	};
+} // namespace NR
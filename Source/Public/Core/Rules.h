@@ -16,6 +16,12 @@
 #pragma once
 #include "muParser.h"
 #include "Types.h"
+#include "GaitTable.h"
+#include <memory>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
 
 static mu::value_type fmod_wrapper(mu::value_type v1, mu::value_type v2)
 {
@@ -34,29 +40,141 @@ static mu::value_type pow_wrapper(mu::value_type v1, mu::value_type v2)
 
 namespace NR
 {
+	/**
+	 * @brief Index of an expression compiled by Rules::Compile.
+	 */
+	using ExprHandle = int32_t;
+	static constexpr ExprHandle InvalidExpr = -1;
+
+	/**
+	 * @brief Gait clock and rule variables of one entity (character).
+	 *
+	 * Rules evaluates one entity at a time: EvaluateEntity loads the context into the
+	 * variables, evaluates every binding and stores the result back, so each entity keeps
+	 * its own gait phase. Create it with Rules::CreateContext.
+	 */
+	struct NRGaitContext
+	{
+		double DeltaTime = 0.0;
+		std::vector<std::vector<double>> Values; // Per binding, in Rules::Vars order
+	};
+
 	class Rules
 	{
 	public:
+		/**
+		 * @brief A rule with every Logic, Condition and Formula expression compiled once at Setup.
+		 */
+		struct CompiledRule
+		{
+			struct Phase
+			{
+				ExprHandle Condition = InvalidExpr;
+				std::vector<ExprHandle> Formulas;
+			};
+
+			/**
+			 * @brief Rule variable fed from the input frame, resolved once against the profile.
+			 */
+			struct InputRead
+			{
+				double* Slot = nullptr;
+				int64_t Offset = -1;  // Float index in the input frame, -1 when the input is missing
+				bool bClock = false;  // t_cycle: accumulated into deltaTime and wrapped by T_gait
+			};
+
+			/**
+			 * @brief Dependency and dirty state of a Logic term, parallel to Logic.
+			 */
+			struct LogicTerm
+			{
+				std::vector<const double*> Reads; // Variables read by the expression
+				std::vector<double> Seen;         // Their values at the last evaluation
+				double Last = 0.0;                // Value written at the last evaluation
+				bool bConstant = false;           // Reads constants only, folded at Setup
+				bool bStateful = false;           // Reads itself or sits in a cycle, always evaluated
+				bool bFresh = false;              // Last, Seen valid
+			};
+
+			/**
+			 * @brief Tabulated phase outputs, see Rules::EnableGaitTables.
+			 */
+			struct TableState
+			{
+				std::shared_ptr<const GaitTable> Table; // Shared by clones
+				double* Phase = nullptr;
+				double* Velocity = nullptr;
+				std::vector<std::pair<double*, double>> Guards; // Other leaves the phases read, value at build time
+				bool bRejected = false;                         // Not tabulable or over tolerance
+			};
+
+			NRRule Source;
+			std::vector<std::pair<double*, ExprHandle>> Logic; // Variable slot, expression, in dependency order
+			std::vector<LogicTerm> Graph;
+			std::vector<Phase> Phases;
+			std::vector<InputRead> Inputs;   // In rule.GetVariables() order, see BindInputs
+			ExprHandle TGait = InvalidExpr;  // Logic term wrapping the gait clock
+			bool bInputsBound = false;
+			TableState Tabulated;
+		};
+
 		double deltaTime = 0.5f;
 		std::vector<mu::Parser> Parsers;
 		std::vector<std::map<std::string, double>> Vars;
+		std::vector<std::vector<CompiledRule>> CompiledRules; // Per binding, in Setup order
 
 		Rules() = default;
 
+		/**
+		 * @brief Deep copy. Parsers and compiled rules are rebound to the copy's own variables,
+		 * so a copy set up once can be handed to another thread.
+		 */
+		Rules(const Rules& other)
+		{
+			CopyFrom(other);
+		}
+
+		Rules& operator=(const Rules& other)
+		{
+			if (this != &other)
+			{
+				Rules copy(other);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		// Moving keeps the map nodes, so every variable pointer stays valid
+		Rules(Rules&&) = default;
+		Rules& operator=(Rules&&) = default;
+
+		/**
+		 * @return Independent copy for a worker thread, see the copy constructor
+		 */
+		[[nodiscard]] Rules Clone() const
+		{
+			return Rules(*this);
+		}
+
 		void Setup(const NRRule& rule, int bindingIndex)
 		{
 			EnsureBinding(bindingIndex);
 
 			std::cout << "Binding " << bindingIndex << "RuleName" << rule.Name << std::endl;
-			for (auto const& [name, val] : rule.Constants)
-			{
-				DefineVariable(name, val, bindingIndex);
-			}
 
-			for (auto const& [varName, _inputList] : rule.Variables)
+			// Rules of a binding usually share one parameter table, define it once
+			if (!rule.Parameters || DefinedParameters[bindingIndex].insert(rule.Parameters.get()).second)
 			{
-				std::cout << "  [RULE " << bindingIndex << "] " << varName << std::endl;
-				DefineVariable(varName, 0.0, bindingIndex);
+				for (auto const& [name, val] : rule.GetConstants())
+				{
+					DefineVariable(name, val, bindingIndex);
+				}
+
+				for (auto const& [varName, _inputList] : rule.GetVariables())
+				{
+					std::cout << "  [RULE " << bindingIndex << "] " << varName << std::endl;
+					DefineVariable(varName, 0.0, bindingIndex);
+				}
 			}
 
 			for (auto const& [logicName, _expr] : rule.Logic)
@@ -76,79 +194,323 @@ namespace NR
 					}
 				}
 			}
+
+			CompiledRule compiled;
+			compiled.Source = rule;
+			for (auto const& [logicName, expr] : rule.Logic)
+			{
+				compiled.Logic.emplace_back(&Vars[bindingIndex][logicName], Compile(bindingIndex, expr));
+				if (logicName == "T_gait")
+				{
+					compiled.TGait = compiled.Logic.back().second;
+				}
+			}
+			BuildLogicGraph(compiled, bindingIndex);
+			for (auto const& phase : rule.Phases)
+			{
+				CompiledRule::Phase& compiledPhase = compiled.Phases.emplace_back();
+				compiledPhase.Condition = Compile(bindingIndex, phase.Condition);
+				for (auto const& [_formulaName, expr] : phase.Formulas)
+				{
+					compiledPhase.Formulas.push_back(Compile(bindingIndex, expr));
+				}
+			}
+			CompiledRules[bindingIndex].push_back(std::move(compiled));
 		}
 
-		void SetTensorInputs(int bindingIndex, const NRRule& rule, const NRModelProfile& profile, const torch::Tensor& currentInput)
+		/**
+		 * @brief Sets up a rule and resolves its inputs against the profile right away.
+		 */
+		void Setup(const NRRule& rule, int bindingIndex, const NRModelProfile& profile)
 		{
-			auto& varMap = Parsers[bindingIndex].GetVar();
+			Setup(rule, bindingIndex);
+			BindInputs(CompiledRules[bindingIndex].back(), bindingIndex, profile);
+		}
 
-			for (auto const& [varName, inputList] : rule.Variables)
+		/**
+		 * @brief Resolves the input offset of every variable of a compiled rule.
+		 *
+		 * Done once, so binding a frame is a plain gather from the input floats instead of
+		 * a name lookup and a tensor slice per variable. The pick follows the binding
+		 * index: Variables[name][bindingIndex] when present, the first entry otherwise.
+		 */
+		void BindInputs(CompiledRule& compiled, int bindingIndex, const NRModelProfile& profile)
+		{
+			compiled.Inputs.clear();
+			for (auto const& [varName, inputList] : compiled.Source.GetVariables())
 			{
-				auto pick = inputList[0];
-				if (inputList.size() > bindingIndex)
+				if (inputList.empty())
 				{
-					pick = inputList[bindingIndex];
+					continue;
 				}
 
-				if (pick == "t_cycle")
+				const auto& pick = inputList.size() > static_cast<size_t>(bindingIndex) ? inputList[bindingIndex] : inputList[0];
+
+				CompiledRule::InputRead read;
+				read.Slot = &Vars[bindingIndex][varName];
+				read.bClock = pick == "t_cycle";
+				for (const auto& block : profile.Inputs)
 				{
-					deltaTime += profile.GetInputBoneValue(currentInput, pick).item<double>();
-					if (auto it = varMap.find(varName); it != varMap.end())
+					if (block.Name == pick)
 					{
-						auto& logics = rule.Logic;
-						auto T_it = std::find_if(logics.begin(), logics.end(), [&](const auto& logic) {
-							return logic.Name == "T_gait";
-						});
-						if (T_it == logics.end())
-						{
-							continue;
-						}
+						read.Offset = block.Offset;
+						break;
+					}
+				}
+
+				if (read.Offset < 0 && !read.bClock)
+				{
+					std::cerr << "[Rules] Input not found for " << varName << ": " << pick << std::endl;
+					continue;
+				}
+				compiled.Inputs.push_back(read);
+			}
+			compiled.bInputsBound = true;
+		}
+
+		/**
+		 * @brief Input and clock reads of a compiled rule, binding them first if Setup did not.
+		 *
+		 * The bulk and tensor evaluators resolve their columns from these, so every path
+		 * reads the same offsets as EvaluateBinding.
+		 */
+		const std::vector<CompiledRule::InputRead>& GetInputs(CompiledRule& compiled, int bindingIndex, const NRModelProfile& profile)
+		{
+			if (!compiled.bInputsBound)
+			{
+				BindInputs(compiled, bindingIndex, profile);
+			}
+			return compiled.Inputs;
+		}
+
+		/**
+		 * @return Variable the T_gait term of a compiled rule writes, nullptr when it has none
+		 */
+		double* GetTGaitSlot(const CompiledRule& compiled, int bindingIndex)
+		{
+			return compiled.TGait != InvalidExpr ? &Vars[bindingIndex].at("T_gait") : nullptr;
+		}
+
+		/**
+		 * @brief Evaluates the rules of a binding for one input frame and writes the active phase.
+		 * @param bindingIndex Binding to evaluate
+		 * @param profile Model profile the rules were set up from
+		 * @param currentInput Input frame [InputSize]
+		 * @param outRow Target row, written at the binding offset
+		 * @param outCount Number of floats in outRow
+		 */
+		void EvaluateBinding(int bindingIndex, const NRModelProfile& profile, const torch::Tensor& currentInput, float* outRow, int64_t outCount)
+		{
+			const auto frame = currentInput.to(torch::kFloat).contiguous();
+			EvaluateBinding(bindingIndex, profile, frame.data_ptr<float>(), outRow, outCount);
+		}
+
+		/**
+		 * @brief Same as above, reading the input frame straight from its floats.
+		 */
+		void EvaluateBinding(int bindingIndex, const NRModelProfile& profile, const float* currentInput, float* outRow, int64_t outCount)
+		{
+			if (bindingIndex >= static_cast<int>(CompiledRules.size()))
+			{
+				return;
+			}
 
-						const auto T_gait = Eval(bindingIndex, T_it->Expr);
-						if (T_gait > 0.0)
+			const int offset = profile.Bindings[bindingIndex].Offset;
+			for (auto& compiled : CompiledRules[bindingIndex])
+			{
+				if (compiled.Logic.empty())
+				{
+					continue;
+				}
+
+				if (!compiled.bInputsBound)
+				{
+					BindInputs(compiled, bindingIndex, profile);
+				}
+
+				SetInputs(compiled, currentInput);
+				EvaluateLogic(compiled);
+
+				if (GaitTables && LookupGaitTable(compiled, bindingIndex, offset, outRow, outCount))
+				{
+					continue;
+				}
+
+				for (const auto& phase : compiled.Phases)
+				{
+					if (Eval(phase.Condition) == 0)
+					{
+						continue;
+					}
+
+					for (size_t f = 0; f < phase.Formulas.size(); ++f)
+					{
+						if (offset + static_cast<int64_t>(f) < outCount)
 						{
-							deltaTime = std::fmod(deltaTime, T_gait);
+							outRow[offset + f] = static_cast<float>(Eval(phase.Formulas[f]));
 						}
+					}
+					break;
+				}
+			}
+		}
 
-						*(it->second) = deltaTime;
+		/**
+		 * @brief Evaluates the Logic terms whose reads changed since their last evaluation.
+		 *
+		 * Terms run in dependency order, so a term sees the values its producers wrote in
+		 * this frame. Folded terms are skipped until DefineVariable changes a binding.
+		 */
+		void EvaluateLogic(CompiledRule& compiled)
+		{
+			for (size_t i = 0; i < compiled.Logic.size(); ++i)
+			{
+				auto& [slot, expr] = compiled.Logic[i];
+				auto& term = compiled.Graph[i];
+
+				if (term.bFresh && !term.bStateful)
+				{
+					// Another evaluator (bulk, tensor) or rule may have written the slot directly
+					bool bDirty = *slot != term.Last;
+					if (term.bConstant && !bDirty)
+					{
+						continue;
+					}
+
+					for (size_t r = 0; r < term.Reads.size() && !bDirty; ++r)
+					{
+						bDirty = *term.Reads[r] != term.Seen[r];
+					}
+					if (!bDirty)
+					{
+						continue;
 					}
+				}
+
+				*slot = Eval(expr);
+				term.Last = *slot;
+				for (size_t r = 0; r < term.Reads.size(); ++r)
+				{
+					term.Seen[r] = *term.Reads[r];
+				}
+				term.bFresh = true;
+			}
+		}
+
+		/**
+		 * @brief Gathers the inputs of a bound rule into its variables and advances the gait clock.
+		 *
+		 * Each t_cycle variable adds its input to deltaTime; when the rule has a T_gait term
+		 * the clock is wrapped by it and written to the variable.
+		 */
+		void SetInputs(const CompiledRule& compiled, const float* currentInput)
+		{
+			for (const auto& read : compiled.Inputs)
+			{
+				const double value = read.Offset >= 0 ? currentInput[read.Offset] : 0.0;
+				if (!read.bClock)
+				{
+					*read.Slot = value;
+					continue;
+				}
+
+				deltaTime += value;
+				if (compiled.TGait == InvalidExpr)
+				{
 					continue;
 				}
 
-				if (auto it = varMap.find(varName); it != varMap.end())
+				const auto T_gait = Eval(compiled.TGait);
+				if (T_gait > 0.0)
 				{
-					*(it->second) = profile.GetInputBoneValue(currentInput, pick).item<double>();
+					deltaTime = std::fmod(deltaTime, T_gait);
 				}
+				*read.Slot = deltaTime;
 			}
 		}
 
-		double Eval(int bindingIndex, const std::string& expression)
+		/**
+		 * @brief Compiles an expression into its own parser sharing the binding variables.
+		 *
+		 * The same text on the same binding always returns the same handle. muParser keeps
+		 * the bytecode after the first evaluation, so later Eval calls skip the tokenizer.
+		 */
+		ExprHandle Compile(int bindingIndex, const std::string& expression)
 		{
+			EnsureBinding(bindingIndex);
+
+			auto& cache = ExprCache[bindingIndex];
+			if (auto it = cache.find(expression); it != cache.end())
+			{
+				return it->second;
+			}
+
+			const auto handle = static_cast<ExprHandle>(Expressions.size());
+			mu::Parser& parser = Expressions.emplace_back(Parsers[bindingIndex]);
+			ExprBindings.push_back(bindingIndex);
+			ExprSources.push_back(expression);
 			try
 			{
-				Parsers[bindingIndex].SetExpr(expression);
+				parser.SetExpr(expression);
+			}
+			catch (mu::Parser::exception_type& e)
+			{
+				std::cout << "Error compiling expression [" << expression << "]: " << e.GetMsg() << std::endl;
+			}
 
-				// DEBUG: dump what the parser actually sees
-				// auto& varStorage = Vars[bindingIndex];
-				// for (auto& [name, val] : varStorage)
-				// {
-				// 	std::cout << "  [STORAGE " << bindingIndex << "] " << name
-				// 			  << " val=" << val << std::endl;
-				// }
+			cache.emplace(expression, handle);
+			return handle;
+		}
 
-				return Parsers[bindingIndex].Eval();
+		double Eval(ExprHandle handle)
+		{
+			try
+			{
+				return Expressions[handle].Eval();
 			}
 			catch (mu::Parser::exception_type& e)
 			{
-				std::cout << "Error evaluating expression [" << expression << "]: " << e.GetMsg() << std::endl;
+				std::cout << "Error evaluating expression [" << ExprSources[handle] << "]: " << e.GetMsg() << std::endl;
 				return 0.0f;
 			}
 		}
 
+		double Eval(int bindingIndex, const std::string& expression)
+		{
+			return Eval(Compile(bindingIndex, expression));
+		}
+
+		[[nodiscard]] const std::string& GetSource(ExprHandle handle) const { return ExprSources[handle]; }
+		[[nodiscard]] int GetBinding(ExprHandle handle) const { return ExprBindings[handle]; }
+
 		void DefineVariable(const std::string& name, double Value = 0.0, int bindingIndex = 0)
 		{
+			const bool bIsNew = !Vars[bindingIndex].contains(name);
 			Vars[bindingIndex][name] = Value;
 			Parsers[bindingIndex].DefineVar(name, &Vars[bindingIndex][name]);
+
+			if (bIsNew)
+			{
+				for (size_t e = 0; e < Expressions.size(); ++e)
+				{
+					if (ExprBindings[e] == bindingIndex)
+					{
+						Expressions[e].DefineVar(name, &Vars[bindingIndex][name]);
+					}
+				}
+			}
+
+			// Folded terms may read it
+			if (bindingIndex < static_cast<int>(CompiledRules.size()))
+			{
+				for (auto& compiled : CompiledRules[bindingIndex])
+				{
+					for (auto& term : compiled.Graph)
+					{
+						term.bFresh = false;
+					}
+				}
+			}
 		}
 
 		void ResetTime()
@@ -156,7 +518,523 @@ namespace NR
 			deltaTime = 0.0f;
 		}
 
+		/**
+		 * @brief Evaluates the phases through tables sampled over phase × velocity.
+		 *
+		 * The table of a rule is built on the first frame evaluated afterwards, with the
+		 * other variables its phases read (bone lengths, constants) fixed at that frame's
+		 * values. Frames where one of them differs, or where phase or velocity fall outside
+		 * the grid, use the exact formulas. Rules whose phases are not continuous enough for
+		 * the tolerance, or don't read the phase variable, are never tabulated.
+		 *
+		 * Read by EvaluateBinding and by BulkEvaluator, which builds the table from the
+		 * first row of its batch. TensorRules always evaluates the exact formulas.
+		 */
+		void EnableGaitTables(const NRGaitTableOptions& options = {})
+		{
+			DisableGaitTables();
+			GaitTables = options;
+		}
+
+		[[nodiscard]] bool HasGaitTables() const { return GaitTables.has_value(); }
+
+		/**
+		 * @brief Gait table of a rule, built from the current variable values on the first call.
+		 * @return nullptr when tables are disabled or the rule cannot be tabulated
+		 */
+		const CompiledRule::TableState* GetGaitTable(CompiledRule& compiled, int bindingIndex)
+		{
+			auto& tabulated = compiled.Tabulated;
+			if (!GaitTables || tabulated.bRejected)
+			{
+				return nullptr;
+			}
+			if (!tabulated.Table && !BuildGaitTable(compiled, bindingIndex))
+			{
+				tabulated = {};
+				tabulated.bRejected = true;
+				return nullptr;
+			}
+			return &tabulated;
+		}
+
+		void DisableGaitTables()
+		{
+			GaitTables.reset();
+			for (auto& binding : CompiledRules)
+			{
+				for (auto& compiled : binding)
+				{
+					compiled.Tabulated = {};
+				}
+			}
+		}
+
+		/**
+		 * @return Context holding the current clock and variable values
+		 */
+		[[nodiscard]] NRGaitContext CreateContext() const
+		{
+			NRGaitContext context;
+			StoreContext(context);
+			return context;
+		}
+
+		void LoadContext(const NRGaitContext& context)
+		{
+			deltaTime = context.DeltaTime;
+			for (size_t b = 0; b < Vars.size() && b < context.Values.size(); ++b)
+			{
+				if (context.Values[b].size() != Vars[b].size())
+				{
+					continue;
+				}
+
+				size_t i = 0;
+				for (auto& [_name, value] : Vars[b])
+				{
+					value = context.Values[b][i++];
+				}
+			}
+		}
+
+		void StoreContext(NRGaitContext& context) const
+		{
+			context.DeltaTime = deltaTime;
+			context.Values.resize(Vars.size());
+			for (size_t b = 0; b < Vars.size(); ++b)
+			{
+				context.Values[b].clear();
+				for (const auto& [_name, value] : Vars[b])
+				{
+					context.Values[b].push_back(value);
+				}
+			}
+		}
+
+		/**
+		 * @brief Evaluates every binding for one entity and keeps its gait state in the context.
+		 * @param context Entity state, updated in place
+		 * @param profile Model profile the rules were set up from
+		 * @param currentInput Input frame of the entity
+		 * @param outRow Target row
+		 * @param outCount Number of floats in outRow
+		 */
+		void EvaluateEntity(NRGaitContext& context, const NRModelProfile& profile, const float* currentInput, float* outRow, int64_t outCount)
+		{
+			LoadContext(context);
+			for (int b = 0; b < static_cast<int>(CompiledRules.size()); ++b)
+			{
+				EvaluateBinding(b, profile, currentInput, outRow, outCount);
+			}
+			StoreContext(context);
+		}
+
 	private:
+		std::optional<NRGaitTableOptions> GaitTables;
+		std::vector<float> TableScratch;
+
+		// One parser per compiled expression, bound to the variables of its binding
+		std::vector<mu::Parser> Expressions;
+		std::vector<int> ExprBindings;
+		std::vector<std::string> ExprSources;
+		std::vector<std::unordered_map<std::string, ExprHandle>> ExprCache;
+		std::vector<std::unordered_set<const NRParameterTable*>> DefinedParameters; // Per binding
+
+		void CopyFrom(const Rules& other)
+		{
+			deltaTime = other.deltaTime;
+			GaitTables = other.GaitTables;
+			Vars = other.Vars;
+			Parsers = other.Parsers;
+			CompiledRules = other.CompiledRules;
+			Expressions = other.Expressions;
+			ExprBindings = other.ExprBindings;
+			ExprSources = other.ExprSources;
+			ExprCache = other.ExprCache;
+			DefinedParameters = other.DefinedParameters;
+
+			// Copied parsers still point at the variables of other
+			std::unordered_map<const double*, double*> remap;
+			for (size_t b = 0; b < Vars.size(); ++b)
+			{
+				for (auto& [name, value] : Vars[b])
+				{
+					remap[&other.Vars[b].at(name)] = &value;
+					Parsers[b].DefineVar(name, &value);
+				}
+			}
+
+			for (size_t e = 0; e < Expressions.size(); ++e)
+			{
+				for (auto& [name, value] : Vars[ExprBindings[e]])
+				{
+					Expressions[e].DefineVar(name, &value);
+				}
+			}
+
+			for (auto& binding : CompiledRules)
+			{
+				for (auto& compiled : binding)
+				{
+					for (auto& [slot, _expr] : compiled.Logic)
+					{
+						slot = remap.at(slot);
+					}
+					for (auto& term : compiled.Graph)
+					{
+						for (auto& read : term.Reads)
+						{
+							read = remap.at(read);
+						}
+					}
+					for (auto& read : compiled.Inputs)
+					{
+						read.Slot = remap.at(read.Slot);
+					}
+
+					auto& tabulated = compiled.Tabulated;
+					if (tabulated.Table)
+					{
+						tabulated.Phase = remap.at(tabulated.Phase);
+						tabulated.Velocity = remap.at(tabulated.Velocity);
+						for (auto& [slot, _value] : tabulated.Guards)
+						{
+							slot = remap.at(slot);
+						}
+					}
+				}
+			}
+		}
+
+		bool LookupGaitTable(CompiledRule& compiled, int bindingIndex, int offset, float* outRow, int64_t outCount)
+		{
+			const auto* state = GetGaitTable(compiled, bindingIndex);
+			if (!state)
+			{
+				return false;
+			}
+
+			const auto& tabulated = *state;
+			for (const auto& [slot, value] : tabulated.Guards)
+			{
+				if (*slot != value)
+				{
+					return false;
+				}
+			}
+
+			const auto& table = *tabulated.Table;
+			TableScratch.resize(table.GetOutputs());
+			if (!table.Lookup(*tabulated.Phase, *tabulated.Velocity, TableScratch.data()))
+			{
+				return false;
+			}
+
+			for (int32_t f = 0; f < table.GetOutputs() && offset + f < outCount; ++f)
+			{
+				outRow[offset + f] = TableScratch[f];
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Runs Logic with the axes forced, then the first true phase, like a frame would.
+		 * @return false if no phase is active at that point
+		 */
+		bool SampleGaitPoint(const CompiledRule& compiled, double phase, double velocity, float* out)
+		{
+			const auto& tabulated = compiled.Tabulated;
+			*tabulated.Velocity = velocity;
+			for (const auto& [slot, expr] : compiled.Logic)
+			{
+				*slot = slot == tabulated.Phase ? phase : Eval(expr);
+			}
+
+			for (const auto& phaseRule : compiled.Phases)
+			{
+				if (Eval(phaseRule.Condition) == 0)
+				{
+					continue;
+				}
+				for (size_t f = 0; f < phaseRule.Formulas.size(); ++f)
+				{
+					out[f] = static_cast<float>(Eval(phaseRule.Formulas[f]));
+				}
+				return true;
+			}
+			return false;
+		}
+
+		bool BuildGaitTable(CompiledRule& compiled, int bindingIndex)
+		{
+			const auto& options = *GaitTables;
+			auto& vars = Vars[bindingIndex];
+			auto& tabulated = compiled.Tabulated;
+
+			auto phaseIt = vars.find(options.PhaseVariable);
+			auto velocityIt = vars.find(options.VelocityVariable);
+			if (phaseIt == vars.end() || velocityIt == vars.end() || compiled.Phases.empty())
+			{
+				return false;
+			}
+			tabulated.Phase = &phaseIt->second;
+			tabulated.Velocity = &velocityIt->second;
+
+			auto logicIndex = [&](const double* slot) {
+				for (size_t i = 0; i < compiled.Logic.size(); ++i)
+				{
+					if (compiled.Logic[i].first == slot)
+					{
+						return static_cast<int64_t>(i);
+					}
+				}
+				return int64_t{-1};
+			};
+			if (logicIndex(tabulated.Phase) < 0 || logicIndex(tabulated.Velocity) >= 0)
+			{
+				return false;
+			}
+
+			// Every phase writes the same outputs, otherwise rows would depend on the phase picked
+			const size_t outputs = compiled.Phases[0].Formulas.size();
+			for (const auto& phase : compiled.Phases)
+			{
+				if (phase.Formulas.size() != outputs || outputs == 0)
+				{
+					return false;
+				}
+			}
+
+			// Leaves read by the phases, through Logic, stopping at the axes
+			std::vector<const double*> pending;
+			auto pushReads = [&](ExprHandle handle) {
+				try
+				{
+					for (const auto& [_name, ptr] : Expressions[handle].GetUsedVar())
+					{
+						if (ptr)
+						{
+							pending.push_back(ptr);
+						}
+					}
+				}
+				catch (mu::Parser::exception_type&)
+				{
+				}
+			};
+			for (const auto& phase : compiled.Phases)
+			{
+				pushReads(phase.Condition);
+				for (const auto handle : phase.Formulas)
+				{
+					pushReads(handle);
+				}
+			}
+
+			bool bReadsPhase = false;
+			std::unordered_set<const double*> visited;
+			tabulated.Guards.clear();
+			while (!pending.empty())
+			{
+				const double* read = pending.back();
+				pending.pop_back();
+				if (read == tabulated.Phase)
+				{
+					bReadsPhase = true;
+					continue;
+				}
+				if (read == tabulated.Velocity || !visited.insert(read).second)
+				{
+					continue;
+				}
+
+				if (const int64_t i = logicIndex(read); i >= 0)
+				{
+					pending.insert(pending.end(), compiled.Graph[i].Reads.begin(), compiled.Graph[i].Reads.end());
+					continue;
+				}
+				tabulated.Guards.emplace_back(const_cast<double*>(read), *read);
+			}
+			if (!bReadsPhase)
+			{
+				return false;
+			}
+
+			std::vector<double> saved;
+			for (const auto& [_name, value] : vars)
+			{
+				saved.push_back(value);
+			}
+
+			auto table = std::make_shared<GaitTable>(options.PhaseMin, options.PhaseMax, options.PhaseSamples,
+			                                         options.VelocityMin, options.VelocityMax, options.VelocitySamples,
+			                                         static_cast<int32_t>(outputs));
+			bool bValid = true;
+			for (int32_t i = 0; i < table->GetPhaseSamples() && bValid; ++i)
+			{
+				for (int32_t j = 0; j < table->GetVelocitySamples() && bValid; ++j)
+				{
+					bValid = SampleGaitPoint(compiled, table->PhaseAt(i), table->VelocityAt(j), table->Cell(i, j));
+				}
+			}
+
+			// Error bound against the exact formulas at random points
+			std::mt19937 rng(7);
+			std::uniform_real_distribution<double> phaseDist(options.PhaseMin, options.PhaseMax);
+			std::uniform_real_distribution<double> velocityDist(options.VelocityMin, options.VelocityMax);
+			std::vector<float> exact(outputs);
+			std::vector<float> approx(outputs);
+			for (int32_t k = 0; k < options.CheckSamples && bValid; ++k)
+			{
+				const double phase = phaseDist(rng);
+				const double velocity = velocityDist(rng);
+				bValid = SampleGaitPoint(compiled, phase, velocity, exact.data()) && table->Lookup(phase, velocity, approx.data());
+				for (size_t f = 0; f < outputs && bValid; ++f)
+				{
+					const double error = std::abs(static_cast<double>(exact[f]) - approx[f]);
+					table->MaxError = std::max(table->MaxError, error);
+					bValid = error <= options.Tolerance; // NaN fails too
+				}
+			}
+
+			size_t restore = 0;
+			for (auto& [_name, value] : vars)
+			{
+				value = saved[restore++];
+			}
+
+			std::cout << "[Rules] Gait table for " << compiled.Source.Name << ": " << (bValid ? "enabled" : "rejected")
+				<< ", max error " << table->MaxError << std::endl;
+			if (!bValid)
+			{
+				return false;
+			}
+
+			tabulated.Table = std::move(table);
+			return true;
+		}
+
+		/**
+		 * @brief Sorts Logic by dependency and folds the terms that only read constants.
+		 *
+		 * Dependencies come from the variables muParser finds in each expression. The sort
+		 * keeps declaration order between independent terms; terms caught in a cycle stay
+		 * in declaration order after the others and read the previous frame.
+		 */
+		void BuildLogicGraph(CompiledRule& compiled, int bindingIndex)
+		{
+			const size_t count = compiled.Logic.size();
+			std::vector<std::vector<const double*>> reads(count);
+			std::vector<std::vector<size_t>> producers(count);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				try
+				{
+					for (const auto& [name, ptr] : Expressions[compiled.Logic[i].second].GetUsedVar())
+					{
+						if (ptr)
+						{
+							reads[i].push_back(ptr);
+						}
+					}
+				}
+				catch (mu::Parser::exception_type& e)
+				{
+					std::cout << "Error compiling expression [" << ExprSources[compiled.Logic[i].second] << "]: " << e.GetMsg() << std::endl;
+				}
+
+				for (const double* read : reads[i])
+				{
+					for (size_t j = 0; j < count; ++j)
+					{
+						if (j != i && compiled.Logic[j].first == read)
+						{
+							producers[i].push_back(j);
+						}
+					}
+				}
+			}
+
+			// Kahn, lowest declaration index first
+			std::vector<size_t> order;
+			std::vector<bool> placed(count, false);
+			std::vector<bool> stateful(count, false);
+			while (order.size() < count)
+			{
+				bool bProgress = false;
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (placed[i])
+					{
+						continue;
+					}
+
+					const bool bReady = std::all_of(producers[i].begin(), producers[i].end(), [&](size_t j) { return placed[j]; });
+					if (bReady)
+					{
+						order.push_back(i);
+						placed[i] = true;
+						bProgress = true;
+						break;
+					}
+				}
+
+				if (!bProgress)
+				{
+					std::cerr << "[Rules] Cyclic Logic in " << compiled.Source.Name << ", keeping declaration order" << std::endl;
+					for (size_t i = 0; i < count; ++i)
+					{
+						if (!placed[i])
+						{
+							order.push_back(i);
+							placed[i] = true;
+							stateful[i] = true;
+						}
+					}
+				}
+			}
+
+			std::unordered_set<const double*> constant;
+			for (auto const& [name, _value] : compiled.Source.GetConstants())
+			{
+				constant.insert(&Vars[bindingIndex][name]);
+			}
+			for (auto const& [varName, _inputList] : compiled.Source.GetVariables())
+			{
+				constant.erase(&Vars[bindingIndex][varName]);
+			}
+			for (const auto& [slot, _expr] : compiled.Logic)
+			{
+				constant.erase(slot);
+			}
+
+			std::vector<std::pair<double*, ExprHandle>> sorted;
+			compiled.Graph.clear();
+			for (const size_t i : order)
+			{
+				sorted.push_back(compiled.Logic[i]);
+
+				CompiledRule::LogicTerm& term = compiled.Graph.emplace_back();
+				term.Reads = reads[i];
+				term.Seen.resize(reads[i].size());
+				term.bStateful = stateful[i] || std::find(reads[i].begin(), reads[i].end(), compiled.Logic[i].first) != reads[i].end();
+				term.bConstant = !term.bStateful && std::all_of(reads[i].begin(), reads[i].end(), [&](const double* read) {
+					return constant.contains(read);
+				});
+
+				if (term.bConstant)
+				{
+					*sorted.back().first = Eval(sorted.back().second);
+					term.Last = *sorted.back().first;
+					term.bFresh = true;
+					constant.insert(sorted.back().first);
+				}
+			}
+			compiled.Logic = std::move(sorted);
+		}
+
 		void EnsureBinding(int bindingIndex)
 		{
 			if (Parsers.empty())
@@ -177,6 +1055,13 @@ namespace NR
 				std::cout << "Binding " << bindingIndex << std::endl;
 			}
 
+			if (bindingIndex >= static_cast<int>(CompiledRules.size()))
+			{
+				CompiledRules.resize(bindingIndex + 1);
+				ExprCache.resize(bindingIndex + 1);
+				DefinedParameters.resize(bindingIndex + 1);
+			}
+
 			if (const bool hasFmod = Parsers[bindingIndex].HasFun("fmod"); !hasFmod)
 			{
 				std::cout << "!hasFmod " << bindingIndex << std::endl;
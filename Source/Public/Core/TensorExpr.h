@@ -0,0 +1,94 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+#include <functional>
+
+namespace NR
+{
+	/**
+	 * @brief Rule expression lowered to libtorch ops.
+	 *
+	 * Accepts the muParser syntax used by the IK profiles: arithmetic, ^, comparisons,
+	 * &&, ||, !, the ternary ?:, the muParser built-in functions and the fmod, clamp,
+	 * pow and _pi extensions of Rules. Variables are tensors (typically one column of a
+	 * batch), so an expression evaluates every sample at once and stays differentiable.
+	 * Comparisons and logical operators produce 0/1 in the input dtype, like muParser.
+	 */
+	class TensorExpr
+	{
+	public:
+		/**
+		 * @brief Maps a variable name to its slot, or -1 when the name is unknown.
+		 */
+		using Resolver = std::function<int32_t(const std::string& Name)>;
+
+		/**
+		 * @brief Parses an expression.
+		 * @param Expression Source text
+		 * @param Resolve Resolves variable names to slots
+		 * @return true if successful, false otherwise (see GetError)
+		 */
+		bool Compile(const std::string& Expression, const Resolver& Resolve);
+
+		/**
+		 * @brief Evaluates the expression.
+		 * @param Vars Tensor of every variable slot; slots read by the expression must be defined
+		 * @param Options Dtype and device of the constants
+		 * @return Result, broadcast over the variables it reads
+		 */
+		[[nodiscard]] torch::Tensor Eval(const std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const;
+
+		/**
+		 * @return Slots read by the expression, without duplicates
+		 */
+		[[nodiscard]] std::vector<int32_t> UsedVars() const;
+
+		[[nodiscard]] bool IsValid() const { return Root >= 0; }
+		[[nodiscard]] const std::string& GetSource() const { return Source; }
+		[[nodiscard]] const std::string& GetError() const { return Error; }
+
+	private:
+		enum class NodeKind : uint8_t
+		{
+			Constant,
+			Variable,
+			Unary,
+			Binary,
+			Ternary,
+			Call
+		};
+
+		struct Node
+		{
+			NodeKind Kind = NodeKind::Constant;
+			std::string Op;              // Operator or function name
+			double Value = 0.0;          // Constant
+			int32_t Slot = -1;           // Variable
+			std::vector<int32_t> Args;   // Child nodes
+		};
+
+		class Parser;
+
+		[[nodiscard]] torch::Tensor EvalNode(int32_t Index, const std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const;
+
+		std::string Source;
+		std::string Error;
+		std::vector<Node> Nodes;
+		int32_t Root = -1;
+	};
+} // namespace NR
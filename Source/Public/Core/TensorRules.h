@@ -0,0 +1,96 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Rules.h"
+#include "Core/TensorExpr.h"
+
+namespace NR
+{
+	/**
+	 * @brief Evaluates the rules of every binding as tensor graphs over a whole batch.
+	 *
+	 * Every Logic, Condition and Formula of Rules is lowered once with TensorExpr. Rule
+	 * variables are input columns, so the targets of a batch come out as one tensor on
+	 * the device of the inputs, and gradients flow back to the inputs when they require
+	 * them. Phases are picked with torch::where masks (first true condition wins).
+	 *
+	 * The gait clock is the only sequential part: it is scanned on the host from the
+	 * t_cycle column and the T_gait of the previous row, exactly like BulkEvaluator, and
+	 * uploaded as a column. The scalar state of Rules follows the last row afterwards.
+	 * Gait tables (Rules::EnableGaitTables) are not read here, phases always use the
+	 * exact formulas.
+	 */
+	class TensorRules
+	{
+	public:
+		/**
+		 * @param Source Rules already set up for every binding of Profile
+		 * @param Profile Model profile
+		 */
+		TensorRules(Rules& Source, const NRModelProfile& Profile);
+
+		/**
+		 * @brief Evaluates the targets of a batch.
+		 * @param Inputs Input frames [Batch, InputSize]
+		 * @param OutCount Number of values per target row
+		 * @return Targets [Batch, OutCount] as float, like the muParser path, on the device of Inputs
+		 */
+		torch::Tensor Evaluate(const torch::Tensor& Inputs, int64_t OutCount);
+
+		/**
+		 * @return false if an expression could not be lowered, Evaluate must not be used then
+		 */
+		[[nodiscard]] bool IsValid() const { return bValid; }
+
+	private:
+		struct RuleProgram
+		{
+			struct Phase
+			{
+				TensorExpr Condition;
+				std::vector<TensorExpr> Formulas;
+			};
+
+			std::vector<std::pair<int32_t, TensorExpr>> Logic; // Variable slot, expression
+			std::vector<Phase> Phases;
+		};
+
+		struct BindingState
+		{
+			int Offset = 0;
+			std::vector<double*> Scalars;               // Slot -> Rules::Vars value
+			std::vector<std::pair<int32_t, int64_t>> InputSlots; // Slot, input offset
+			std::vector<RuleProgram> Programs;
+
+			// Variables bound to t_cycle, in the order Rules::SetInputs visits them
+			struct ClockRead
+			{
+				int32_t Slot = -1;
+				ExprHandle TGait = InvalidExpr; // Clock is not wrapped (nor written) without T_gait
+				int32_t TGaitSlot = -1;
+			};
+			std::vector<ClockRead> ClockReads;
+		};
+
+		void RunLogic(const RuleProgram& Program, std::vector<torch::Tensor>& Vars, const torch::TensorOptions& Options) const;
+
+		Rules& Source;
+		std::vector<BindingState> Bindings;
+		int64_t TCycleInput = -1;
+		bool bValid = true;
+	};
+} // namespace NR
@@ -15,6 +15,8 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -99,13 +101,22 @@ namespace NR
 		torch::Tensor Max; // [MaxX, MaxY, MaxZ]
 	};
 
+	/**
+	 * @brief Schema.Parameters of an IK profile, parsed once and shared by every rule.
+	 */
+	struct NRParameterTable
+	{
+		int32_t Id = -1; // Index in NRModelProfile::ParameterTables
+		std::map<std::string, double> Constants;
+		std::vector<NRVars> Variables;
+	};
+
 	struct NRRule
 	{
 		torch::Tensor RestRotationEuler;
 
 		std::string Name;
-		std::map<std::string, double> Constants;
-		std::vector<NRVars> Variables;
+		std::shared_ptr<const NRParameterTable> Parameters; // Immutable, shared between rules
 		std::vector<NRLogic> Logic;
 		RotationLimit Limits;
 
@@ -117,6 +128,23 @@ namespace NR
 		};
 
 		std::vector<Phase> Phases;
+
+		[[nodiscard]] const std::map<std::string, double>& GetConstants() const
+		{
+			return Parameters ? Parameters->Constants : NoParameters().Constants;
+		}
+
+		[[nodiscard]] const std::vector<NRVars>& GetVariables() const
+		{
+			return Parameters ? Parameters->Variables : NoParameters().Variables;
+		}
+
+	private:
+		static const NRParameterTable& NoParameters()
+		{
+			static const NRParameterTable empty;
+			return empty;
+		}
 	};
 
 	struct NRSkeleton
@@ -166,6 +194,7 @@ namespace NR
 		std::string BoneName;
 		std::string RuleName;
 		std::vector<NRRule> Rules;
+		int32_t ParametersId = -1;
 		int Size;
 		int Offset;
 	};
@@ -176,6 +205,7 @@ namespace NR
 		std::vector<NRBinding> Bindings;
 		std::vector<NRDataBlock> Inputs;
 		std::vector<NRDataBlock> Outputs;
+		std::vector<std::shared_ptr<const NRParameterTable>> ParameterTables;
 
 		NRSkeleton Skeleton;
 		NRTrainingWeights TrainingWeights;
@@ -237,6 +267,7 @@ namespace NR
 			return {};
 		}
 
+		// Lookups above and sums below walk the blocks on every call, per-frame code uses NRProfileView
 		[[nodiscard]] int32_t GetRequiredInputSize() const
 		{
 			int32_t totalSize = 0;
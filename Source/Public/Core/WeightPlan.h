@@ -0,0 +1,67 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Kinematics.h"
+#include "Core/Types.h"
+#include <array>
+
+namespace NR
+{
+	/**
+	 * @brief Loss terms read by the trainer, in the order of NRWeightPlan::Loss.
+	 */
+	enum class NRLossSlot : uint8_t
+	{
+		Objective,
+		Position,
+		Kinematics,
+		Temporal,
+		Acceleration,
+		SmoothOutput,
+		QuaternionNorm,
+		Count
+	};
+
+	/**
+	 * @brief Dense form of NRTrainingWeights, compiled once per skeleton layout.
+	 *
+	 * Loss weights are stored by slot and bone biases as tensors indexed by the
+	 * layout bone id, so the training loop never hashes or compares names.
+	 */
+	struct NRWeightPlan
+	{
+		std::array<float, static_cast<size_t>(NRLossSlot::Count)> Loss{};
+
+		torch::Tensor BonePosition; // [NBones] PositionMultiplier, 1 when unset
+		torch::Tensor BoneRotation; // [NBones] RotationMultiplier, 1 when unset
+
+		[[nodiscard]] float Get(NRLossSlot Slot) const { return Loss[static_cast<size_t>(Slot)]; }
+
+		/**
+		 * @brief Name of a slot as written in the TW profile.
+		 */
+		static const char* SlotName(NRLossSlot Slot);
+
+		/**
+		 * @brief Compiles the training weights against a skeleton layout.
+		 * @param Weights Weights loaded from the TW profile; missing losses default to 1
+		 * @param Layout Skeleton layout the bone biases are resolved against
+		 * @return Dense weight plan
+		 */
+		static NRWeightPlan Compile(const NRTrainingWeights& Weights, const NRKinematicLayout& Layout);
+	};
+} // namespace NR
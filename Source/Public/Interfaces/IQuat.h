@@ -17,5 +17,54 @@ namespace NR
 		virtual Quat ToQuat(float pitch, float yaw, float roll) const = 0;
 
 		virtual Vec3 ToEuler(const Quat& q) const = 0;
+
+		/**
+		 * @brief Converts a batch of Euler angles to quaternions.
+		 *
+		 * The default calls ToQuat once per row and is not differentiable; converters
+		 * used on hot paths should override it with tensor ops (see DefaultQuat).
+		 * @param Euler Tensor of shape [..., 3] holding [pitch, yaw, roll] in radians
+		 * @return Tensor of shape [..., 4] holding [x, y, z, w]
+		 */
+		virtual Quat ToQuatBatch(const Vec3& Euler) const
+		{
+			auto rows = Euler.detach().to(torch::kFloat).reshape({-1, 3}).contiguous();
+			auto acc = rows.accessor<float, 2>();
+
+			std::vector<torch::Tensor> quats;
+			quats.reserve(rows.size(0));
+			for (int64_t i = 0; i < rows.size(0); ++i)
+			{
+				quats.push_back(ToQuat(acc[i][0], acc[i][1], acc[i][2]).reshape({4}));
+			}
+
+			auto sizes = Euler.sizes().vec();
+			sizes.back() = 4;
+			return quats.empty() ? torch::empty(sizes) : torch::stack(quats).reshape(sizes);
+		}
+
+		/**
+		 * @brief Converts a batch of quaternions to Euler angles.
+		 *
+		 * The default calls ToEuler once per row; override it when ToEuler already
+		 * handles [N, 4] tensors.
+		 * @param Q Tensor of shape [..., 4] holding [x, y, z, w]
+		 * @return Tensor of shape [..., 3] holding [pitch, yaw, roll] in radians
+		 */
+		virtual Vec3 ToEulerBatch(const Quat& Q) const
+		{
+			auto rows = Q.reshape({-1, 4});
+
+			std::vector<torch::Tensor> angles;
+			angles.reserve(rows.size(0));
+			for (int64_t i = 0; i < rows.size(0); ++i)
+			{
+				angles.push_back(ToEuler(rows[i]).reshape({3}));
+			}
+
+			auto sizes = Q.sizes().vec();
+			sizes.back() = 3;
+			return angles.empty() ? torch::empty(sizes, Q.options()) : torch::stack(angles).reshape(sizes);
+		}
 	};
 }
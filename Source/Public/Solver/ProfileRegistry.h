@@ -0,0 +1,135 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/CompiledProfile.h"
+#include "Core/Types.h"
+#include "Interfaces/IModel.h"
+#include "Interfaces/IQuat.h"
+#include "Solver/Solver.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief A profile held by the registry with everything needed to serve it.
+	 */
+	struct NRRegisteredProfile
+	{
+		std::string Id;
+		std::string Topology;           // See ProfileRegistry::TopologyKey
+		NRCompiledProfile Compiled;     // Profile, rules, skeleton layout and weight plan
+		std::shared_ptr<IModel<float>> Model; // Shared by every profile with the same topology
+		std::unique_ptr<Solver> ProfileSolver;
+	};
+
+	/**
+	 * @brief One input frame addressed to a registered profile.
+	 */
+	struct NRProfileFrame
+	{
+		int32_t Profile = -1; // Handle returned by ProfileRegistry::Register / Find
+		std::vector<float> Input;
+	};
+
+	/**
+	 * @brief Serves several rig profiles from one process.
+	 *
+	 * Profiles are registered under an id and addressed afterwards by an integer handle,
+	 * so dispatching a frame never hashes a string. Models are created through a factory
+	 * and shared between profiles whose input and output blocks and skeleton hierarchy
+	 * match (see TopologyKey). Solve() groups
+	 * incoming frames by profile and runs one batched forward per profile.
+	 *
+	 * Register and Solve must not run concurrently; register between frames.
+	 */
+	class ProfileRegistry
+	{
+	public:
+		/**
+		 * @brief Creates the model of a topology seen for the first time.
+		 */
+		using ModelFactory = std::function<std::shared_ptr<IModel<float>>(const NRModelProfile&)>;
+
+		explicit ProfileRegistry(ModelFactory InFactory, torch::Device InDevice = torch::kCPU);
+
+		/**
+		 * @brief Adds a profile, or replaces the profile registered under the same id.
+		 * @param Id Profile id, usually NRModelProfile::ProfileName
+		 * @param Profile Profile with skeleton and training weights loaded
+		 * @param Base Rules the profile's evaluator is copied from
+		 * @return Handle of the profile, -1 if no model could be created for it
+		 */
+		int32_t Register(const std::string& Id, NRModelProfile Profile, const Rules& Base = {});
+
+		/**
+		 * @brief Loads the IK, SK and TW files of a profile and registers it.
+		 * @param Id Profile id
+		 * @param CachePath Compiled profile cache, empty to parse the JSON directly
+		 * @return Handle of the profile, -1 on failure
+		 */
+		int32_t Load(const std::string& Id, const std::string& IKPath, const std::string& SKPath, const std::string& TWPath,
+		             IQuat* Quat, const std::string& CachePath = {});
+
+		/**
+		 * @return Handle of the profile registered under Id, -1 if there is none
+		 */
+		[[nodiscard]] int32_t Find(const std::string& Id) const;
+
+		/**
+		 * @return The registered profile, nullptr for an invalid handle
+		 */
+		[[nodiscard]] const NRRegisteredProfile* Get(int32_t Handle) const;
+
+		[[nodiscard]] size_t Num() const { return Entries.size(); }
+
+		/**
+		 * @brief Number of distinct models, at most Num().
+		 */
+		[[nodiscard]] size_t NumModels() const { return Models.size(); }
+
+		/**
+		 * @brief Solves one frame.
+		 * @return Outputs of the profile, empty for an invalid handle or a short frame
+		 */
+		std::vector<float> Solve(int32_t Handle, const std::vector<float>& Input);
+
+		/**
+		 * @brief Solves frames of any mix of profiles, batching the frames of each profile together.
+		 * @param Frames One row of inputs per frame
+		 * @return Outputs in the order of Frames; empty for frames that could not be solved
+		 */
+		std::vector<std::vector<float>> Solve(const std::vector<NRProfileFrame>& Frames);
+
+		/**
+		 * @brief Profiles with equal keys have the same input and output blocks (name, offset,
+		 * size) and the same skeleton hierarchy, so one model fits them all.
+		 */
+		static std::string TopologyKey(const NRCompiledProfile& Compiled);
+
+	private:
+		ModelFactory Factory;
+		torch::Device Device;
+
+		std::vector<std::unique_ptr<NRRegisteredProfile>> Entries; // Indexed by handle
+		std::unordered_map<std::string, int32_t> Handles;
+		std::unordered_map<std::string, std::shared_ptr<IModel<float>>> Models; // By topology
+	};
+} // namespace NR
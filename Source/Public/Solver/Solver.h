@@ -18,6 +18,8 @@
 
 #include <utility>
 
+#include "Core/Kinematics.h"
+#include "Core/ProfileView.h"
 #include "Core/Types.h"
 #include "Interfaces/IModel.h"
 
@@ -43,6 +45,8 @@ namespace NR
 		    , RigDesc(Description)
 		    , Device(DeviceTarget)
 		{
+			RigView = NRProfileView(RigDesc);
+			SkeletonLayout = Kinematics::BuildLayout(RigDesc.Skeleton);
 			NeuralNetwork->to(Device);
 			NeuralNetwork->eval();
 		}
@@ -54,6 +58,29 @@ namespace NR
 		 */
 		std::vector<float> Solve(const std::vector<float>& Inputs);
 
+		/**
+		 * @brief Rescales the predicted bone quaternions to unit length before returning them.
+		 *
+		 * Applied to the rotation columns of every skeleton bone in one gather/scatter,
+		 * using the flattened skeleton layout built with the solver. Disabled by default.
+		 * @param bEnable true to normalize the rotations
+		 */
+		void NormalizeRotations(bool bEnable) { bNormalizeRotations = bEnable; }
+
+		/**
+		 * @brief Projects every predicted pose onto the skeleton's bone constraints.
+		 *
+		 * Unit quaternions and rest bone lengths, see Kinematics::ConstrainPose. Uses the
+		 * kernel compiled for the skeleton's topology when there is one. Disabled by default.
+		 * @param bEnable true to constrain the outputs
+		 */
+		void ConstrainBones(bool bEnable) { bConstrainBones = bEnable; }
+
+		/**
+		 * @brief Block handles and sizes of the rig, to read the outputs of Solve per bone.
+		 */
+		[[nodiscard]] const NRProfileView& GetView() const { return RigView; }
+
 	private:
 		/**
 		 * @brief Unique pointer to the neural network model used for solving.
@@ -73,6 +100,19 @@ namespace NR
 		 * descriptor for setting up and manipulating rig-based systems.
 		 */
 		NRModelProfile RigDesc;
+
+		/**
+		 * @brief Flattened skeleton of RigDesc, built once with the solver.
+		 */
+		NRKinematicLayout SkeletonLayout;
+
+		/**
+		 * @brief Cached sizes and block handles of RigDesc.
+		 */
+		NRProfileView RigView;
+
+		bool bNormalizeRotations = false;
+		bool bConstrainBones = false;
 	};
 
 } // namespace NR
@@ -0,0 +1,112 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/Types.h"
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace NR
+{
+	/**
+	 * @brief Writes model + optimizer checkpoints without stalling the training loop.
+	 *
+	 * Save() copies the parameters, buffers and Adam state in memory on the calling
+	 * thread; serialization happens on a worker thread. Files are written next to the
+	 * target, renamed over it atomically, and the previous versions are kept as
+	 * Path.1 ... Path.N. The model is stored at the archive root, so a checkpoint is
+	 * still readable by torch::load(Model, Path); the optimizer lives under "optimizer".
+	 */
+	class Checkpointer
+	{
+	public:
+		/**
+		 * @brief In-memory copy of a module tree, mirrors torch::nn::Module::save.
+		 */
+		struct ModuleSnapshot
+		{
+			std::vector<std::pair<std::string, torch::Tensor>> Parameters;
+			std::vector<std::pair<std::string, torch::Tensor>> Buffers;
+			std::vector<std::string> ChildNames;
+			std::vector<ModuleSnapshot> Children;
+		};
+
+		struct Snapshot
+		{
+			ModuleSnapshot Model;
+			std::shared_ptr<torch::optim::Adam> Optimizer; // Copy bound to the cloned parameters
+			std::string Path;
+		};
+
+		/**
+		 * @param KeepVersions Number of previous checkpoints kept next to the latest one
+		 */
+		explicit Checkpointer(int32_t KeepVersions = 3);
+		~Checkpointer();
+
+		Checkpointer(const Checkpointer&) = delete;
+		Checkpointer& operator=(const Checkpointer&) = delete;
+
+		/**
+		 * @brief Takes a snapshot and queues it for a background write.
+		 *
+		 * If a previous snapshot is still waiting, it is replaced by this one.
+		 * @param Model Module to save
+		 * @param Optimizer Optimizer whose state is saved with the model
+		 * @param Path Destination file
+		 */
+		void Save(const torch::nn::Module& Model, const torch::optim::Adam& Optimizer, const std::string& Path);
+
+		/**
+		 * @brief Blocks until every queued checkpoint has been written.
+		 */
+		void Wait();
+
+		/**
+		 * @brief Copies a model and its optimizer state.
+		 */
+		static Snapshot Capture(const torch::nn::Module& Model, const torch::optim::Adam& Optimizer, const std::string& Path);
+
+		/**
+		 * @brief Serializes a snapshot to disk (temp file + rename + rotation).
+		 * @return true if successful, false otherwise
+		 */
+		static bool Write(const Snapshot& Data, int32_t KeepVersions);
+
+		/**
+		 * @brief Loads a checkpoint written by Write, or a plain torch::save of the model.
+		 * @param Model Module to restore
+		 * @param Optimizer Optimizer to restore, skipped when null or absent from the file
+		 * @param Path Source file
+		 * @return true if the optimizer state was restored as well
+		 */
+		static bool Load(torch::nn::Module& Model, torch::optim::Adam* Optimizer, const std::string& Path);
+
+	private:
+		void Run();
+
+		int32_t KeepVersions;
+
+		std::mutex Mutex;
+		std::condition_variable Signal;
+		std::optional<Snapshot> Pending;
+		bool bWriting = false;
+		bool bStopping = false;
+		std::thread Worker;
+	};
+} // namespace NR
@@ -0,0 +1,149 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace NR
+{
+	/**
+	 * @brief On-disk header of a recorded dataset (.nrds).
+	 *
+	 * The header is followed by FrameCount records of InputSize + TargetSize
+	 * little-endian floats each: the network input, then the ideal target when
+	 * the dataset was baked with targets (TargetSize == 0 otherwise).
+	 */
+	struct NRDatasetHeader
+	{
+		static constexpr uint32_t MagicValue = 0x5344524E; // "NRDS"
+		static constexpr uint32_t CurrentVersion = 1;
+
+		uint32_t Magic = MagicValue;
+		uint32_t Version = CurrentVersion;
+		uint64_t FrameCount = 0;
+		uint32_t InputSize = 0;
+		uint32_t TargetSize = 0;
+	};
+
+	/**
+	 * @brief Read-only, memory-mapped view of a recorded dataset.
+	 *
+	 * Frames are paged in by the OS on access, so a capture larger than RAM can be
+	 * iterated without loading it.
+	 */
+	class FrameDataset
+	{
+	public:
+		FrameDataset() = default;
+		~FrameDataset();
+
+		FrameDataset(const FrameDataset&) = delete;
+		FrameDataset& operator=(const FrameDataset&) = delete;
+
+		/**
+		 * @brief Maps a dataset file.
+		 * @param Path File written by FrameDatasetWriter
+		 * @return true if the file was mapped and its header is valid
+		 */
+		bool Open(const std::string& Path);
+
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const { return Records != nullptr; }
+		[[nodiscard]] uint64_t FrameCount() const { return Header.FrameCount; }
+		[[nodiscard]] int32_t InputSize() const { return static_cast<int32_t>(Header.InputSize); }
+		[[nodiscard]] int32_t TargetSize() const { return static_cast<int32_t>(Header.TargetSize); }
+		[[nodiscard]] bool HasTargets() const { return Header.TargetSize > 0; }
+
+		/**
+		 * @return Pointer to the InputSize floats of a frame
+		 */
+		[[nodiscard]] const float* Input(uint64_t Frame) const { return Records + Frame * RecordSize(); }
+
+		/**
+		 * @return Pointer to the TargetSize floats of a frame, only valid when HasTargets()
+		 */
+		[[nodiscard]] const float* Target(uint64_t Frame) const { return Input(Frame) + Header.InputSize; }
+
+		/**
+		 * @brief Hints the OS that the given frames will be read soon.
+		 */
+		void Prefetch(uint64_t First, uint64_t Count) const;
+
+	private:
+		[[nodiscard]] uint64_t RecordSize() const { return static_cast<uint64_t>(Header.InputSize) + Header.TargetSize; }
+
+		NRDatasetHeader Header;
+		const float* Records = nullptr;
+		void* MappedView = nullptr;
+		uint64_t MappedBytes = 0;
+#ifdef _WIN32
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+#else
+		int FileHandle = -1;
+#endif
+	};
+
+	/**
+	 * @brief Appends frames to a dataset file, e.g. while recording a live session.
+	 */
+	class FrameDatasetWriter
+	{
+	public:
+		FrameDatasetWriter() = default;
+		~FrameDatasetWriter();
+
+		FrameDatasetWriter(const FrameDatasetWriter&) = delete;
+		FrameDatasetWriter& operator=(const FrameDatasetWriter&) = delete;
+
+		/**
+		 * @brief Creates (or truncates) a dataset file.
+		 * @param Path Destination file
+		 * @param InputSize Floats per input frame
+		 * @param TargetSize Floats per target, 0 to record inputs only
+		 * @return true if the file could be created
+		 */
+		bool Open(const std::string& Path, int32_t InputSize, int32_t TargetSize = 0);
+
+		/**
+		 * @brief Appends one frame.
+		 * @param Input InputSize floats
+		 * @param Target TargetSize floats, ignored for input-only datasets
+		 * @return false if the file is not open or the sizes don't match
+		 */
+		bool Append(const std::vector<float>& Input, const std::vector<float>& Target = {});
+
+		/**
+		 * @brief Appends one frame from raw buffers of InputSize and TargetSize floats.
+		 */
+		bool Append(const float* Input, const float* Target);
+
+		/**
+		 * @brief Writes the final frame count and closes the file.
+		 */
+		void Close();
+
+		[[nodiscard]] uint64_t FrameCount() const { return Header.FrameCount; }
+
+	private:
+		NRDatasetHeader Header;
+		std::ofstream File;
+	};
+} // namespace NR
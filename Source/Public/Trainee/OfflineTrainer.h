@@ -0,0 +1,109 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/BoundedQueue.h"
+#include "Trainee/FrameDataset.h"
+#include "Trainee/Trainee.h"
+#include <atomic>
+#include <functional>
+
+namespace NR
+{
+	struct NROfflineOptions
+	{
+		int32_t Epochs = 1;
+		int32_t MiniBatch = 64;
+		bool bShuffle = true;
+		uint64_t Seed = 42;
+		int32_t PrefetchBatches = 4;  // Minibatches prepared ahead of the optimizer
+		std::string CheckpointPath;   // Written after every epoch when not empty
+	};
+
+	/**
+	 * @brief Multi-epoch minibatch training from a recorded dataset.
+	 *
+	 * A producer thread gathers the frames of upcoming minibatches from the mapped
+	 * file (and evaluates their targets when the dataset has none) while the calling
+	 * thread runs the optimizer.
+	 *
+	 * With baked targets, frames are shuffled individually. Without them, targets
+	 * depend on the gait time accumulated frame by frame, so only the order of
+	 * contiguous MiniBatch-sized windows is shuffled, and every window is evaluated
+	 * from the rule state the recorded order leaves before it. That state is taken by
+	 * one in-order pass before the first shuffled epoch, so targets are the same in
+	 * every epoch. Use BakeTargets once to get per-frame shuffling.
+	 */
+	template<FloatingPoint T = float>
+	class OfflineTrainer
+	{
+	public:
+		using EpochCallback = std::function<void(int32_t Epoch, float MeanLoss)>;
+
+		OfflineTrainer(Trainee<T>& Trainer, const FrameDataset& Data, NROfflineOptions Options = {});
+
+		/**
+		 * @brief Trains for Options.Epochs epochs.
+		 * @param OnEpoch Called after every epoch with its mean loss
+		 * @return Mean loss of the last epoch, or a negative value if nothing was trained
+		 */
+		float Run(const EpochCallback& OnEpoch = {});
+
+		/**
+		 * @brief Stops Run() after the current step, may be called from another thread.
+		 */
+		void Cancel() { bCancelled = true; }
+
+		/**
+		 * @brief Evaluates the rules over a dataset in recorded order and writes a copy with targets.
+		 * @param Trainer Trainee whose rules produce the targets
+		 * @param Source Dataset with inputs only
+		 * @param Path Destination file
+		 * @param Chunk Number of frames evaluated per call
+		 * @return true if successful, false otherwise
+		 */
+		static bool BakeTargets(Trainee<T>& Trainer, const FrameDataset& Source, const std::string& Path, int32_t Chunk = 4096);
+
+	private:
+		struct Batch
+		{
+			torch::Tensor Input;
+			torch::Tensor Target;
+			bool bEpochEnd = false;
+		};
+
+		void Produce(BoundedQueue<Batch>& Queue);
+		Batch Gather(const std::vector<uint64_t>& Frames);
+
+		/**
+		 * @brief Frames of a contiguous window, in recorded order.
+		 */
+		void WindowFrames(uint64_t Window, std::vector<uint64_t>& Frames) const;
+
+		/**
+		 * @brief Brings the trainee's rules to the state window Window starts from in recorded order.
+		 *
+		 * The first time a window is reached its state is recorded, later visits load it.
+		 */
+		void EnterWindow(uint64_t Window);
+
+		Trainee<T>& Trainer;
+		const FrameDataset& Data;
+		NROfflineOptions Options;
+		std::atomic<bool> bCancelled{false};
+		std::vector<NRGaitContext> WindowStates; // Per window, filled in recorded order
+	};
+} // namespace NR
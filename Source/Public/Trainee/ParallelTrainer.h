@@ -0,0 +1,132 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Trainee/TargetPipeline.h"
+#include "Trainee/Trainee.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace NR
+{
+	/**
+	 * @brief Hogwild data-parallel training over several worker threads.
+	 *
+	 * Every worker owns a Trainee with its own Adam moments and gradients. The first
+	 * worker trains the shared model directly; the others train replicas whose parameters
+	 * alias the shared storage, so each optimizer step is applied in place, without
+	 * locks, to the weights every worker reads.
+	 *
+	 * Submitted frames are grouped into minibatches in arrival order, and their targets
+	 * are evaluated in that order by a single TargetPipeline producer on the first
+	 * worker's rules, so the gait clock sees every t_cycle increment. The prepared
+	 * (input, target) pairs go to whichever worker is free; since a worker's steps are
+	 * not consecutive frames, its prediction history is cleared before each step.
+	 *
+	 * Torch intra-op parallelism is set to one thread while the workers run, the cores
+	 * are used by the workers instead; Stop() restores the previous setting.
+	 */
+	template<FloatingPoint T = float>
+	class ParallelTrainer
+	{
+	public:
+		using ModelFactory = std::function<std::shared_ptr<IModel<T> >()>;
+
+		/**
+		 * @param SharedModel Model being trained, also used by the first worker
+		 * @param Factory Creates an empty model with the same architecture for the other workers
+		 * @param QCustom Quaternion converter shared by every worker (must be stateless)
+		 * @param Rig Model profile
+		 * @param NumWorkers Number of training threads, 0 uses the hardware concurrency
+		 * @param MiniBatch Number of frames per optimizer step
+		 * @param LearningRate Fallback learning rate when TW.json does not define one
+		 */
+		ParallelTrainer(std::shared_ptr<IModel<T> > SharedModel, ModelFactory Factory, IQuat* QCustom, const NRModelProfile& Rig, int32_t NumWorkers = 0, int32_t MiniBatch = 8, double LearningRate = 1e-3);
+		~ParallelTrainer();
+
+		ParallelTrainer(const ParallelTrainer&) = delete;
+		ParallelTrainer& operator=(const ParallelTrainer&) = delete;
+
+		/**
+		 * @brief Queues one or more input frames, blocks while the workers are behind.
+		 *
+		 * Frames are held until MiniBatch of them have arrived, then their targets are evaluated.
+		 * @param InputFloats Frames laid out as [N, InputSize]; trailing floats past the last
+		 * whole frame are dropped so they cannot shift the rows of a minibatch
+		 * @return false once the trainer has been stopped
+		 */
+		bool Submit(std::vector<float> InputFloats);
+
+		/**
+		 * @brief Trains on the frames still queued, joins the workers and restores the torch thread count.
+		 */
+		void Stop();
+
+		/**
+		 * @brief Requests a checkpoint of the shared model with the first worker's optimizer.
+		 *
+		 * The first worker takes the snapshot between two of its steps, so the Adam state
+		 * is never copied while it is being updated. A newer request replaces one not yet taken.
+		 * @param Path Destination file
+		 */
+		void SaveCheckpointAsync(const std::string& Path);
+
+		[[nodiscard]] int32_t NumWorkers() const { return static_cast<int32_t>(Workers.size()); }
+		[[nodiscard]] uint64_t Steps() const { return StepCount.load(std::memory_order_relaxed); }
+		[[nodiscard]] float LastLoss() const { return LossValue.load(std::memory_order_relaxed); }
+
+	private:
+		struct Worker
+		{
+			std::shared_ptr<IModel<T> > Model;
+			std::unique_ptr<Trainee<T> > Trainer;
+			std::thread Thread;
+		};
+
+		void Run(Worker& Self);
+
+		/**
+		 * @brief Starts the checkpoint requested by SaveCheckpointAsync, if any. First worker only.
+		 */
+		void SavePendingCheckpoint(Trainee<T>& Trainer);
+
+		/**
+		 * @brief Points every parameter and buffer of Replica at the storage of Source.
+		 * @return false if the two modules don't have the same layout
+		 */
+		static bool ShareStorage(torch::nn::Module& Replica, const torch::nn::Module& Source);
+
+		int32_t InCount = 0;
+		int32_t MiniBatch = 1;
+		int32_t PreviousThreads = 0; // Torch intra-op threads before the workers started, 0 once restored
+
+		std::mutex SubmitMutex;      // Keeps frames in order while they are grouped into minibatches
+		std::vector<float> Batch;    // Frames of the minibatch being grouped
+		bool bStopped = false;
+
+		std::mutex CheckpointMutex;
+		std::optional<std::string> CheckpointPath;
+
+		std::vector<std::unique_ptr<Worker> > Workers;
+		std::unique_ptr<TargetPipeline<T> > Targets; // After Workers, it evaluates on the first worker's Trainee
+
+		std::atomic<uint64_t> StepCount{0};
+		std::atomic<float> LossValue{0.0f};
+	};
+} // namespace NR
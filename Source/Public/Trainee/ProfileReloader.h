@@ -0,0 +1,77 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/CompiledProfile.h"
+#include "Core/FileWatcher.h"
+#include "Core/Rules.h"
+#include "Core/Types.h"
+#include "Interfaces/IQuat.h"
+#include <mutex>
+#include <optional>
+
+namespace NR
+{
+	/**
+	 * @brief Rebuilds a profile in the background whenever its IK, SK or TW file changes.
+	 *
+	 * Parsing and rule compilation run on the watcher thread. The result waits in
+	 * TakePending() until the training loop picks it up between frames and hands it
+	 * to Trainee::Reload, so a frame never sees half of an old and half of a new profile.
+	 * A profile that fails to load is reported and ignored; the current one stays active.
+	 */
+	class ProfileReloader
+	{
+	public:
+		/**
+		 * @param IKPath Rules and schema (IK.json)
+		 * @param SKPath Skeleton (SK.json)
+		 * @param TWPath Training weights (TW.json)
+		 * @param Quat Converter for the rest rotations, must outlive the reloader
+		 * @param CachePath Compiled profile cache refreshed on reload, empty to parse the JSON directly
+		 * @param Base Rules the new evaluator is copied from (keeps options such as gait tables)
+		 */
+		ProfileReloader(std::string IKPath, std::string SKPath, std::string TWPath, IQuat* Quat,
+		                std::string CachePath = {}, Rules Base = {});
+
+		/**
+		 * @brief Starts watching the three files.
+		 * @return false if the files could not be watched
+		 */
+		bool Start();
+		void Stop();
+
+		/**
+		 * @brief Takes the latest rebuilt profile, if one is waiting. Older ones are dropped.
+		 */
+		std::optional<NRCompiledProfile> TakePending();
+
+	private:
+		void Rebuild();
+
+		std::string IKPath;
+		std::string SKPath;
+		std::string TWPath;
+		std::string CachePath;
+		IQuat* Quat = nullptr;
+		Rules Base;
+
+		std::mutex PendingMutex;
+		std::optional<NRCompiledProfile> Pending;
+
+		FileWatcher Watcher; // Last, so it stops before the members it uses are destroyed
+	};
+} // namespace NR
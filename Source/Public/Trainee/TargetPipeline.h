@@ -0,0 +1,144 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#pragma once
+
+#include "Core/BoundedQueue.h"
+#include "Trainee/Trainee.h"
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace NR
+{
+	/**
+	 * @brief Per-stage timings of a TargetPipeline, averaged over the completed steps.
+	 */
+	struct NRPipelineStats
+	{
+		uint64_t Steps = 0;
+		uint64_t Dropped = 0;   // Frames refused by TrySubmit because the pipeline was full
+		double TargetMs = 0.0;  // Rule evaluation (SetInputs, Logic, Phases) on the producer
+		double QueueMs = 0.0;   // Time a ready target waited before its step started
+		double StepMs = 0.0;    // Forward, backward and optimizer step
+	};
+
+	/**
+	 * @brief Evaluates ideal targets on a producer thread while the trainer runs its steps.
+	 *
+	 * Frames go through two bounded queues: the producer turns submitted frames into
+	 * (input, target) pairs, and Step() trains on them in order. While the pipeline is
+	 * running, the producer owns the trainee's rule evaluator, so the trainee must not
+	 * be used through TrainStep(InputFloats) or ComputeTargets at the same time.
+	 */
+	template<FloatingPoint T = float>
+	class TargetPipeline
+	{
+	public:
+		/**
+		 * @param Trainer Trainee that evaluates the rules and runs the steps
+		 * @param Depth Number of frames the producer may run ahead of the trainer
+		 */
+		explicit TargetPipeline(Trainee<T>& Trainer, size_t Depth = 4);
+		~TargetPipeline();
+
+		TargetPipeline(const TargetPipeline&) = delete;
+		TargetPipeline& operator=(const TargetPipeline&) = delete;
+
+		/**
+		 * @brief Queues a frame, blocks while the producer is Depth frames ahead.
+		 * @return false once the pipeline has been stopped
+		 */
+		bool Submit(std::vector<float> InputFloats);
+
+		/**
+		 * @brief Queues a frame without blocking; the frame is dropped when the pipeline is full.
+		 * @return true if the frame was queued
+		 */
+		bool TrySubmit(std::vector<float> InputFloats);
+
+		/**
+		 * @brief Trains on the next prepared frame, waiting for it if needed.
+		 * @return The step loss, or nullopt once the pipeline is stopped and drained
+		 */
+		std::optional<float> Step();
+
+		/**
+		 * @brief Trains on the next prepared frame if one is ready.
+		 * @return The step loss, or nullopt when nothing was ready
+		 */
+		std::optional<float> TryStep();
+
+		/**
+		 * @brief Takes the next prepared (input, target) pair without training on it, waiting for it if needed.
+		 *
+		 * For callers that run the steps on other trainees (see ParallelTrainer); the
+		 * targets are still evaluated in submission order by the one producer.
+		 * @return The pair, or nullopt once the pipeline is stopped and drained
+		 */
+		std::optional<std::pair<torch::Tensor, torch::Tensor> > Take();
+
+		/**
+		 * @brief Stops accepting frames and joins the producer once every queued frame is prepared.
+		 *
+		 * Unlike Stop(), waits for room in Ready, so another thread must keep calling Step() or Take().
+		 */
+		void Finish();
+
+		/**
+		 * @brief Stops accepting frames and joins the producer. Prepared frames can still be drained with Step().
+		 *
+		 * Never waits for a step: frames the producer cannot queue because Ready is full are dropped.
+		 */
+		void Stop();
+
+		[[nodiscard]] NRPipelineStats Stats() const;
+
+		/**
+		 * @brief Keeps the producer away from the trainee while the lock is held.
+		 *
+		 * Frames already prepared keep their targets. Used to swap profiles between
+		 * frames, see Trainee::Reload.
+		 */
+		[[nodiscard]] std::unique_lock<std::mutex> LockTrainer();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		struct Prepared
+		{
+			torch::Tensor Input;
+			torch::Tensor Target;
+			Clock::time_point ReadyAt;
+		};
+
+		void Produce();
+		float Train(Prepared& Item);
+
+		Trainee<T>& Trainer;
+		std::mutex TrainerMutex; // Held by the producer while it evaluates targets
+		int32_t InCount = 0;
+
+		BoundedQueue<std::vector<float> > Pending;
+		BoundedQueue<Prepared> Ready;
+		std::thread Producer;
+
+		mutable std::mutex StatsMutex;
+		NRPipelineStats Totals;
+		uint64_t Evaluated = 0;
+	};
+} // namespace NR
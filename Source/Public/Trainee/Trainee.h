@@ -19,8 +19,17 @@
 #include "Interfaces/IModel.h"
 #include <vector>
 
+#include "Core/BulkEvaluator.h"
+#include "Core/CompiledProfile.h"
+#include "Core/DefaultQuat.h"
+#include "Core/Diagnostics.h"
+#include "Core/Kinematics.h"
+#include "Core/ProfileView.h"
 #include "Core/Rules.h"
+#include "Core/TensorRules.h"
+#include "Core/WeightPlan.h"
 #include "Interfaces/IQuat.h"
+#include "Trainee/Checkpointer.h"
 
 namespace NR
 {
@@ -36,9 +45,20 @@ namespace NR
 		std::vector<std::deque<float> > IdealXHistory;
 
 		Rules Evaluator;
+		std::unique_ptr<BulkEvaluator> BulkTargets;
+		std::unique_ptr<TensorRules> TensorTargets; // Set by UseTensorTargets
 		NRModelProfile RigDesc;
+		NRProfileView RigView; // Sizes and block handles of RigDesc
+		NRKinematicLayout SkeletonLayout;
+		NRWeightPlan Weights;
+		Checkpointer Checkpoints;
+		DefaultQuat FallbackQuat;
 		std::unordered_map<std::string, NRRule> V_rules;
 
+		/**
+		 * @brief Takes over a compiled profile and rebuilds the evaluators that depend on it.
+		 */
+		void Adopt(NRCompiledProfile&& Compiled);
 
 	public:
 		/**
@@ -54,7 +74,13 @@ namespace NR
 		torch::Tensor PredHistory;
 		torch::Tensor PredHistory2;
 		torch::Tensor SmoothedOutput;
-		IQuat* QuatConverter = nullptr;
+		IQuat* QuatConverter = nullptr; // DefaultQuat is used when null
+
+		/**
+		 * Loss diagnostics, disabled by default. Call Diag.Enable(Interval) to print
+		 * the loss breakdown every Interval frames from a background thread.
+		 */
+		Diagnostics Diag;
 
 
 		std::vector<torch::Tensor> PredictionCandidates;
@@ -84,6 +110,45 @@ namespace NR
 		 */
 		float TrainStep(const std::vector<float>& InputFloats);
 
+		/**
+		 * @brief Runs one optimizer step on a minibatch whose targets are already known.
+		 * @param Input Network input [Batch, InputSize]
+		 * @param Target Ideal targets [Batch, OutputSize], see ComputeTargets
+		 * @return Total loss of the step
+		 */
+		float TrainStep(const torch::Tensor& Input, const torch::Tensor& Target);
+
+		/**
+		 * @brief Evaluates the rules of every binding for each row of the input.
+		 *
+		 * Rows are evaluated in order, so gait time advances once per row. Batches of more
+		 * than one row go through the bulk evaluator, or through TensorRules after
+		 * UseTensorTargets(true), in which case the targets stay on the device of Input.
+		 * @param Input Network input [Batch, InputSize] or [InputSize]
+		 * @return Ideal targets [Batch, OutputSize]
+		 */
+		torch::Tensor ComputeTargets(const torch::Tensor& Input);
+
+		/**
+		 * @brief Switches ComputeTargets to the rules lowered as tensor graphs.
+		 * @param bEnable true to use TensorRules, false to go back to muParser
+		 * @return false if a rule expression could not be lowered (muParser stays in use)
+		 */
+		bool UseTensorTargets(bool bEnable);
+
+		/**
+		 * @brief Swaps in a profile rebuilt by ProfileReloader.
+		 *
+		 * Must be called between frames, with no TargetPipeline evaluating targets
+		 * (see TargetPipeline::LockTrainer). Model, optimizer and prediction history are
+		 * kept, which requires the same input and output blocks. The gait clock and every
+		 * rule variable still defined after the reload keep their value; constants are
+		 * taken from the new profile.
+		 * @param Compiled Profile, rules, layout and weight plan to use from now on
+		 * @return false if the layout differs; the current profile stays active
+		 */
+		bool Reload(NRCompiledProfile&& Compiled);
+
 
 		/**
 		 * @brief Calculates all losses based on the training weights configuration (TW.json).
@@ -97,6 +162,9 @@ namespace NR
 
 		/**
 		 * @brief Performs Forward Kinematics to validate the skeleton hierarchy and bone lengths.
+		 *
+		 * The whole skeleton is evaluated at once through Kinematics::Forward, so the
+		 * number of recorded ops depends on the hierarchy depth, not on the bone count.
 		 * @param Pred Neural network prediction
 		 * @param Target Original network input (used to extract IK targets)
 		 * @return Tensor containing FK error (bone chain integrity)
@@ -106,8 +174,45 @@ namespace NR
 		// ... existing code ...
 		void Reset();
 
+		/**
+		 * @brief Forgets the previous predictions used by the temporal and smoothing losses.
+		 *
+		 * Needed when consecutive steps don't see consecutive frames (shuffled minibatches).
+		 */
+		void ClearHistory();
+
+		/**
+		 * @return Gait clock and rule variables the next ComputeTargets call starts from
+		 */
+		[[nodiscard]] NRGaitContext CreateGaitContext() const { return Evaluator.CreateContext(); }
+
+		/**
+		 * @brief Restores a state taken with CreateGaitContext, so targets are evaluated from it.
+		 */
+		void LoadGaitContext(const NRGaitContext& Context) { Evaluator.LoadContext(Context); }
+
+		[[nodiscard]] const NRModelProfile& GetProfile() const { return RigDesc; }
+		[[nodiscard]] const NRProfileView& GetProfileView() const { return RigView; }
+
+		/**
+		 * @brief Saves the model and the optimizer state synchronously.
+		 * @param Path Destination file
+		 */
 		void SaveWeights(const std::string& Path);
 
+		/**
+		 * @brief Snapshots the model and the optimizer state and writes them on a background thread.
+		 *
+		 * Only the in-memory copy happens on the calling thread. The previous checkpoints
+		 * are kept as Path.1, Path.2, ...
+		 * @param Path Destination file
+		 */
+		void SaveCheckpointAsync(const std::string& Path);
+
+		/**
+		 * @brief Restores the model and, when present in the file, the optimizer state.
+		 * @param Path Source file
+		 */
 		void LoadWeights(const std::string& Path);
 	};
 } // namespace NR
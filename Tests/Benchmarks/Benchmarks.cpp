@@ -0,0 +1,423 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Core/CompiledProfile.h"
+#include "Core/DefaultQuat.h"
+#include "Core/Kinematics.h"
+#include "Core/Parse.h"
+#include "Solver/Solver.h"
+#include "Trainee/Trainee.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+#include "Network/NetworkClient.h"
+#include "Network/NetworkServer.h"
+#endif
+
+// Microbenchmarks of the solver, trainer, rules, loaders and network hot paths.
+//
+// Usage: NRBenchmarks [--out=NRBenchmarks.json] [--filter=<substring>] [--min-time=<seconds>]
+//
+// Every benchmark runs once to warm up, then grows its iteration count until a run
+// lasts at least --min-time. Results are printed as a table and written as JSON in
+// the layout of Google Benchmark (context + benchmarks[]), so two releases can be
+// compared with its compare.py or a plain diff.
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	volatile float Sink = 0.0f; // Keeps the optimizer from dropping benchmarked work
+
+	struct BenchmarkResult
+	{
+		std::string Name;
+		int64_t Iterations = 0;
+		double RealNs = 0.0; // Per iteration
+		double CpuNs = 0.0;  // Per iteration, process CPU time
+		double ItemsPerSecond = 0.0;
+	};
+
+	class BenchmarkRunner
+	{
+	public:
+		std::string Filter;
+		double MinTime = 0.5;
+		std::vector<BenchmarkResult> Results;
+
+		/**
+		 * @param Items Items processed per iteration (frames, bytes...), for the throughput column
+		 */
+		void Run(const std::string& Name, const std::function<void()>& Body, int64_t Items = 1)
+		{
+			if (!Filter.empty() && Name.find(Filter) == std::string::npos)
+			{
+				return;
+			}
+
+			Body();
+
+			int64_t iterations = 1;
+			while (true)
+			{
+				const auto cpuStart = std::clock();
+				const auto start = Clock::now();
+				for (int64_t i = 0; i < iterations; ++i)
+				{
+					Body();
+				}
+				const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+				const double cpuSeconds = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+				if (seconds >= MinTime || iterations >= (int64_t(1) << 30))
+				{
+					BenchmarkResult result;
+					result.Name = Name;
+					result.Iterations = iterations;
+					result.RealNs = seconds * 1e9 / static_cast<double>(iterations);
+					result.CpuNs = cpuSeconds * 1e9 / static_cast<double>(iterations);
+					result.ItemsPerSecond = seconds > 0.0 ? static_cast<double>(Items * iterations) / seconds : 0.0;
+
+					std::cout << std::left << std::setw(48) << Name << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+					          << result.RealNs << " ns" << std::setw(14) << result.CpuNs << " ns" << std::setw(12) << iterations
+					          << std::setw(16) << std::setprecision(0) << result.ItemsPerSecond << " items/s" << std::endl;
+					Results.push_back(result);
+					return;
+				}
+
+				// Aim straight for MinTime once the run is long enough to be measured
+				const double scale = seconds > MinTime / 100.0 ? MinTime * 1.4 / seconds : 10.0;
+				iterations = std::max(iterations + 1, static_cast<int64_t>(static_cast<double>(iterations) * std::min(scale, 10.0)));
+			}
+		}
+
+		[[nodiscard]] nlohmann::ordered_json ToJson(const std::string& ProfileName) const
+		{
+			const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+			std::ostringstream date;
+			date << std::put_time(std::localtime(&now), "%Y-%m-%dT%H:%M:%S");
+
+			nlohmann::ordered_json json;
+			json["context"] = {
+				{"date", date.str()},
+				{"executable", "NRBenchmarks"},
+				{"num_cpus", std::thread::hardware_concurrency()},
+				{"torch_threads", at::get_num_threads()},
+				{"profile", ProfileName},
+#ifdef NDEBUG
+				{"library_build_type", "release"},
+#else
+				{"library_build_type", "debug"},
+#endif
+			};
+
+			json["benchmarks"] = nlohmann::ordered_json::array();
+			for (const auto& result : Results)
+			{
+				json["benchmarks"].push_back({
+					{"name", result.Name},
+					{"run_type", "iteration"},
+					{"iterations", result.Iterations},
+					{"real_time", result.RealNs},
+					{"cpu_time", result.CpuNs},
+					{"time_unit", "ns"},
+					{"items_per_second", result.ItemsPerSecond},
+				});
+			}
+			return json;
+		}
+	};
+
+	class NRBenchmarkModel : public NR::IModel<float>
+	{
+	public:
+		torch::nn::Sequential Layers{nullptr};
+
+		NRBenchmarkModel(int64_t InSize, int64_t Hidden, int64_t OutSize)
+		{
+			Layers = register_module("layers", torch::nn::Sequential(
+				                                   torch::nn::Linear(InSize, Hidden),
+				                                   torch::nn::LayerNorm(torch::nn::LayerNormOptions({Hidden})),
+				                                   torch::nn::ELU(),
+				                                   torch::nn::Linear(Hidden, Hidden),
+				                                   torch::nn::ELU(),
+				                                   torch::nn::Linear(Hidden, OutSize)));
+		}
+
+		torch::Tensor Forward(torch::Tensor Input) override
+		{
+			return Layers->forward(Input);
+		}
+
+		void SaveModel(const std::string& FilePath) override
+		{
+			torch::save(shared_from_this(), FilePath);
+		}
+
+		void LoadModel(const std::string& FilePath) override
+		{
+			auto self = shared_from_this();
+			torch::load(self, FilePath);
+		}
+	};
+
+	std::vector<float> RandomFrames(int64_t Batch, int64_t Size)
+	{
+		auto frames = torch::randn({Batch, Size}).contiguous();
+		return {frames.data_ptr<float>(), frames.data_ptr<float>() + frames.numel()};
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	using namespace NR;
+
+	BenchmarkRunner Runner;
+	std::string OutPath = "NRBenchmarks.json";
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg.rfind("--out=", 0) == 0)
+		{
+			OutPath = arg.substr(6);
+		}
+		else if (arg.rfind("--filter=", 0) == 0)
+		{
+			Runner.Filter = arg.substr(9);
+		}
+		else if (arg.rfind("--min-time=", 0) == 0)
+		{
+			Runner.MinTime = std::stod(arg.substr(11));
+		}
+		else
+		{
+			std::cerr << "Usage: NRBenchmarks [--out=<path>] [--filter=<substring>] [--min-time=<seconds>]" << std::endl;
+			return 1;
+		}
+	}
+
+	std::string DataAssetPath_IK = "Tests/Datasets/Foot_IK.json";
+	std::string DataAssetPath_SK = "Tests/Datasets/Foot_SK.json";
+	std::string DataAssetPath_TW = "Tests/Datasets/Foot_TW.json";
+	if (!std::filesystem::exists(DataAssetPath_IK))
+	{
+		DataAssetPath_IK = "Datasets/Foot_IK.json";
+		DataAssetPath_SK = "Datasets/Foot_SK.json";
+		DataAssetPath_TW = "Datasets/Foot_TW.json";
+	}
+	if (!std::filesystem::exists(DataAssetPath_IK))
+	{
+		DataAssetPath_IK = "../Tests/Datasets/Foot_IK.json";
+		DataAssetPath_SK = "../Tests/Datasets/Foot_SK.json";
+		DataAssetPath_TW = "../Tests/Datasets/Foot_TW.json";
+	}
+
+	// Rest rotations are converted as in a real run, a null converter would leave them identity
+	DefaultQuat Quat;
+	NRModelProfile Profile;
+	if (!Parse::LoadIKFromJson(DataAssetPath_IK, Profile)
+	    || !Parse::LoadSKFromJson(DataAssetPath_SK, Profile.Skeleton, &Quat)
+	    || !Parse::LoadTWFromJson(DataAssetPath_TW, Profile.TrainingWeights))
+	{
+		std::cerr << "Failed to load profile assets: " << DataAssetPath_IK << ", " << DataAssetPath_SK << ", " << DataAssetPath_TW << std::endl;
+		return 1;
+	}
+
+	torch::manual_seed(7);
+	const int64_t InputSize = Profile.GetRequiredInputSize();
+	const int64_t OutputSize = Profile.GetRequiredOutputSize();
+	std::cout << "Profile " << Profile.ProfileName << ": " << InputSize << " inputs, " << OutputSize << " outputs" << std::endl;
+
+	// --- Loaders ---
+	Runner.Run("Parse/LoadIKFromJson", [&] {
+		NRModelProfile profile;
+		Sink = Parse::LoadIKFromJson(DataAssetPath_IK, profile) ? 1.0f : 0.0f;
+	});
+	Runner.Run("Parse/LoadSKFromJson", [&] {
+		NRSkeleton skeleton;
+		Sink = Parse::LoadSKFromJson(DataAssetPath_SK, skeleton, &Quat) ? 1.0f : 0.0f;
+	});
+	Runner.Run("Parse/LoadTWFromJson", [&] {
+		NRTrainingWeights weights;
+		Sink = Parse::LoadTWFromJson(DataAssetPath_TW, weights) ? 1.0f : 0.0f;
+	});
+
+	// --- Rules ---
+	NRCompiledProfile Compiled = NRCompiledProfile::Compile(Profile, Rules{});
+	Rules& Evaluator = Compiled.Evaluator;
+	const std::vector<float> Frame = RandomFrames(1, InputSize);
+	std::vector<float> TargetRow(OutputSize, 0.0f);
+
+	Runner.Run("Rules/SetInputs", [&] {
+		for (const auto& binding : Evaluator.CompiledRules)
+		{
+			for (const auto& compiled : binding)
+			{
+				Evaluator.SetInputs(compiled, Frame.data());
+			}
+		}
+		Sink = static_cast<float>(Evaluator.deltaTime);
+	});
+
+	Runner.Run("Rules/Eval", [&] {
+		double sum = 0.0;
+		for (const auto& binding : Evaluator.CompiledRules)
+		{
+			for (const auto& compiled : binding)
+			{
+				for (const auto& phase : compiled.Phases)
+				{
+					sum += Evaluator.Eval(phase.Condition);
+					for (const auto formula : phase.Formulas)
+					{
+						sum += Evaluator.Eval(formula);
+					}
+				}
+			}
+		}
+		Sink = static_cast<float>(sum);
+	});
+
+	Runner.Run("Rules/EvaluateBinding", [&] {
+		for (int b = 0; b < static_cast<int>(Evaluator.CompiledRules.size()); ++b)
+		{
+			Evaluator.EvaluateBinding(b, Compiled.Profile, Frame.data(), TargetRow.data(), OutputSize);
+		}
+		Sink = TargetRow[0];
+	});
+
+	// --- Kinematics ---
+	const NRKinematicLayout& Layout = Compiled.Layout;
+	for (const int64_t batch : {1, 64, 1024})
+	{
+		const auto suffix = "/batch:" + std::to_string(batch);
+		const std::vector<float> poses = RandomFrames(batch, OutputSize);
+		std::vector<float> globalPos(batch * Layout.NumBones() * 3);
+		std::vector<float> globalRot(batch * Layout.NumBones() * 9);
+		const auto poseTensor = torch::from_blob(const_cast<float*>(poses.data()), {batch, OutputSize});
+
+		Runner.Run("Kinematics/Forward" + suffix, [&] {
+			torch::NoGradGuard noGrad;
+			Sink = Kinematics::Forward(Layout, poseTensor).GlobalPos[0][0][0].item<float>();
+		}, batch);
+
+		Runner.Run("Kinematics/ForwardPose" + suffix, [&] {
+			Kinematics::ForwardPose(Layout, poses.data(), batch, OutputSize, globalPos.data(), globalRot.data());
+			Sink = globalPos[0];
+		}, batch);
+
+		if (Layout.Fixed)
+		{
+			auto generic = Layout;
+			generic.Fixed = nullptr;
+			Runner.Run("Kinematics/ForwardPoseGeneric" + suffix, [&] {
+				Kinematics::ForwardPose(generic, poses.data(), batch, OutputSize, globalPos.data(), globalRot.data());
+				Sink = globalPos[0];
+			}, batch);
+		}
+	}
+
+	// --- Solver ---
+	auto SolverModel = std::make_shared<NRBenchmarkModel>(InputSize, 512, OutputSize);
+	Solver ProfileSolver(SolverModel, Profile);
+	for (const int64_t batch : {1, 8, 64, 256})
+	{
+		const std::vector<float> inputs = RandomFrames(batch, InputSize);
+		Runner.Run("Solver/Solve/batch:" + std::to_string(batch), [&] {
+			Sink = ProfileSolver.Solve(inputs)[0];
+		}, batch);
+	}
+
+	// --- Trainee ---
+	auto TraineeModel = std::make_shared<NRBenchmarkModel>(InputSize, 512, OutputSize);
+	Rules TraineeRules;
+	Trainee<float> ProfileTrainee(TraineeModel, &Quat, Profile, TraineeRules, 1e-3);
+
+	Runner.Run("Trainee/TrainStep", [&] {
+		Sink = ProfileTrainee.TrainStep(Frame);
+	});
+
+	for (const int64_t batch : {1, 32})
+	{
+		const auto suffix = "/batch:" + std::to_string(batch);
+		const auto input = torch::randn({batch, InputSize});
+		const auto pred = torch::randn({batch, OutputSize}, torch::requires_grad());
+		const auto target = ProfileTrainee.ComputeTargets(input);
+		const auto prevPred = torch::randn({batch, OutputSize});
+
+		Runner.Run("Trainee/ComputeTargets" + suffix, [&] {
+			Sink = ProfileTrainee.ComputeTargets(input)[0][0].item<float>();
+		}, batch);
+
+		Runner.Run("Trainee/ComputeFK" + suffix, [&] {
+			Sink = ProfileTrainee.ComputeFK(pred, target).item<float>();
+		}, batch);
+
+		Runner.Run("Trainee/ComputeLoss" + suffix, [&] {
+			Sink = ProfileTrainee.ComputeLoss(pred, target, input, prevPred).TotalLoss.item<float>();
+		}, batch);
+	}
+
+	// --- Network ---
+#ifdef _WIN32
+	NetworkServer Server;
+	NetworkClient Client;
+	const int Port = 8090;
+	if (Server.Start(Port))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		const std::vector<float> packet = RandomFrames(1, InputSize);
+		std::vector<float> received;
+
+		// One frame sent to and read back from the loopback interface; the server socket
+		// is non-blocking, a datagram lost on the way is given up after a second
+		Runner.Run("Network/LoopbackRoundTrip", [&] {
+			Client.Send(packet, "127.0.0.1", Port);
+			const auto deadline = Clock::now() + std::chrono::seconds(1);
+			while (!Server.Receive(received) && Clock::now() < deadline)
+			{
+			}
+			Sink = received.empty() ? 0.0f : received[0];
+		});
+		Server.Stop();
+	}
+	else
+	{
+		std::cerr << "Network benchmark skipped, could not start the server on port " << Port << std::endl;
+	}
+#endif
+
+	std::ofstream out(OutPath);
+	if (!out)
+	{
+		std::cerr << "Failed to write " << OutPath << std::endl;
+		return 1;
+	}
+	out << Runner.ToJson(Profile.ProfileName).dump(2) << std::endl;
+	std::cout << "Results written to " << OutPath << std::endl;
+	return 0;
+}
@@ -0,0 +1,137 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Core/Kinematics.h"
+#include "Core/Parse.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+// Validates the fused FK chain operator against the autograd reference and
+// against central finite differences (gradcheck) in double precision, and the
+// FK kernel compiled for the Foot_SK topology against the torch and generic FK.
+int main()
+{
+	using namespace NR;
+
+	std::string DataAssetPath_SK = "Tests/Datasets/Foot_SK.json";
+	if (!std::filesystem::exists(DataAssetPath_SK))
+	{
+		DataAssetPath_SK = "../Tests/Datasets/Foot_SK.json";
+	}
+
+	NRSkeleton Skeleton;
+	if (!Parse::LoadSKFromJson(DataAssetPath_SK, Skeleton, nullptr))
+	{
+		std::cerr << "Failed to load SK asset: " << DataAssetPath_SK << std::endl;
+		return 1;
+	}
+
+	auto Layout = Kinematics::BuildLayout(Skeleton);
+	const int64_t NumBones = Layout.NumBones();
+	const int64_t Batch = 4;
+
+	torch::manual_seed(7);
+	auto options = torch::TensorOptions().dtype(torch::kDouble);
+	auto pos = torch::randn({Batch, NumBones, 3}, options);
+	auto quat = torch::randn({Batch, NumBones, 4}, options);
+	auto target = torch::randn({Batch, NumBones, 3}, options);
+	auto lengthWeight = torch::rand({NumBones}, options);
+	auto ikWeight = torch::rand({NumBones}, options);
+
+	// 1. Fused operator against the autograd reference
+	auto posA = pos.clone().requires_grad_(true);
+	auto quatA = quat.clone().requires_grad_(true);
+	auto fused = Kinematics::ChainLoss(Layout, posA, quatA, target, lengthWeight, ikWeight);
+	fused.backward();
+
+	auto posB = pos.clone().requires_grad_(true);
+	auto quatB = quat.clone().requires_grad_(true);
+	auto reference = Kinematics::ChainLossReference(Layout, posB, quatB, target, lengthWeight, ikWeight);
+	reference.backward();
+
+	const double valueError = std::abs(fused.item<double>() - reference.item<double>());
+	const double posError = (posA.grad() - posB.grad()).abs().max().item<double>();
+	const double quatError = (quatA.grad() - quatB.grad()).abs().max().item<double>();
+	std::cout << "Fused vs reference: loss " << valueError << ", dPos " << posError << ", dQuat " << quatError << std::endl;
+
+	// 2. Analytic gradient against central finite differences
+	const double eps = 1e-6;
+	double fdError = 0.0;
+	auto checkInput = [&](torch::Tensor& input, const torch::Tensor& analytic) {
+		auto flat = input.view({-1});
+		auto grad = analytic.reshape({-1});
+		for (int64_t i = 0; i < flat.numel(); ++i)
+		{
+			torch::NoGradGuard NoGrad;
+			const double original = flat[i].item<double>();
+			flat[i] = original + eps;
+			const double plus = Kinematics::ChainLoss(Layout, pos, quat, target, lengthWeight, ikWeight).item<double>();
+			flat[i] = original - eps;
+			const double minus = Kinematics::ChainLoss(Layout, pos, quat, target, lengthWeight, ikWeight).item<double>();
+			flat[i] = original;
+
+			const double numeric = (plus - minus) / (2.0 * eps);
+			fdError = std::max(fdError, std::abs(numeric - grad[i].item<double>()));
+		}
+	};
+	checkInput(pos, posA.grad());
+	checkInput(quat, quatA.grad());
+	std::cout << "Finite differences: max error " << fdError << std::endl;
+
+	// Kernel compiled for the Foot_SK topology against the torch FK and the generic loop
+	if (!Layout.Fixed)
+	{
+		std::cerr << "No fixed kernel registered for the Foot_SK topology" << std::endl;
+		return 1;
+	}
+
+	const int64_t stride = Layout.Offsets.back() + 7;
+	auto pose = torch::randn({Batch, stride});
+	auto fk = Kinematics::Forward(Layout, pose);
+
+	auto fixedPos = torch::empty({Batch, NumBones, 3});
+	auto fixedRot = torch::empty({Batch, NumBones, 3, 3});
+	Kinematics::ForwardPose(Layout, pose.data_ptr<float>(), Batch, stride, fixedPos.data_ptr<float>(), fixedRot.data_ptr<float>());
+
+	auto generic = Layout;
+	generic.Fixed = nullptr;
+	auto genericPos = torch::empty_like(fixedPos);
+	auto genericRot = torch::empty_like(fixedRot);
+	Kinematics::ForwardPose(generic, pose.data_ptr<float>(), Batch, stride, genericPos.data_ptr<float>(), genericRot.data_ptr<float>());
+
+	auto fixedPose = pose.clone();
+	auto genericPose = pose.clone();
+	Kinematics::ConstrainPose(Layout, fixedPose.data_ptr<float>(), Batch, stride);
+	Kinematics::ConstrainPose(generic, genericPose.data_ptr<float>(), Batch, stride);
+
+	const double fixedError = std::max((fixedPos - fk.GlobalPos).abs().max().item<double>(), (fixedRot - fk.GlobalRot).abs().max().item<double>());
+	const double genericError = std::max((fixedPos - genericPos).abs().max().item<double>(), (fixedRot - genericRot).abs().max().item<double>());
+	const double constrainError = (fixedPose - genericPose).abs().max().item<double>();
+	std::cout << "Fixed kernel " << Layout.Fixed->Name << ": vs torch " << fixedError << ", vs generic " << genericError
+	          << ", constraints " << constrainError << std::endl;
+
+	const double tolerance = 1e-6;
+	if (valueError > tolerance || posError > tolerance || quatError > tolerance || fdError > 1e-5
+	    || fixedError > 1e-4 || genericError > 1e-6 || constrainError > 1e-6)
+	{
+		std::cerr << "Kinematics validation failed!" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Validation completed!" << std::endl;
+	return 0;
+}
@@ -0,0 +1,316 @@
+// Project: NeuraRig
+// Copyright (c) 2026 Rafael Valoto
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Core/BulkEvaluator.h"
+#include "Core/DefaultQuat.h"
+#include "Core/Parse.h"
+#include "Core/Rules.h"
+#include "Core/TensorExpr.h"
+#include "Trainee/Trainee.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+// Validates the rule evaluators against muParser on Foot_IK: the bulk path against the
+// scalar EvaluateBinding path (targets and gait clock), every expression lowered by
+// TensorExpr against Rules::Eval, and the TensorRules targets against ComputeTargets on
+// the muParser path. The bulk check also runs with every Logic block in reverse order,
+// so the dependency sort of Rules is exercised, and the gait tables are checked against
+// the exact formulas on both the scalar and the bulk path.
+namespace
+{
+	using namespace NR;
+
+	Rules SetupRules(const NRModelProfile& Profile)
+	{
+		Rules evaluator;
+		for (size_t i = 0; i < Profile.Bindings.size(); ++i)
+		{
+			for (const auto& rule : Profile.Bindings[i].Rules)
+			{
+				evaluator.Setup(rule, static_cast<int>(i), Profile);
+			}
+		}
+		return evaluator;
+	}
+
+	torch::Tensor EvaluateScalar(Rules& Evaluator, const NRModelProfile& Profile, const torch::Tensor& Frames, int64_t OutCount)
+	{
+		auto targets = torch::zeros({Frames.size(0), OutCount});
+		for (int64_t r = 0; r < Frames.size(0); ++r)
+		{
+			for (size_t b = 0; b < Profile.Bindings.size(); ++b)
+			{
+				Evaluator.EvaluateBinding(static_cast<int>(b), Profile, Frames[r].data_ptr<float>(), targets[r].data_ptr<float>(), OutCount);
+			}
+		}
+		return targets;
+	}
+
+	bool CheckBulk(const char* Label, const NRModelProfile& Profile, const torch::Tensor& Frames)
+	{
+		const int64_t outCount = Profile.GetRequiredOutputSize();
+		const Rules base = SetupRules(Profile);
+
+		Rules scalar = base;
+		const auto expected = EvaluateScalar(scalar, Profile, Frames, outCount);
+
+		Rules bulk = base;
+		BulkEvaluator evaluator(bulk, Profile);
+		auto targets = torch::zeros({Frames.size(0), outCount});
+		evaluator.Evaluate(Frames, targets.data_ptr<float>(), outCount);
+
+		const double targetError = (targets - expected).abs().max().item<double>();
+		const double clockError = std::abs(bulk.deltaTime - scalar.deltaTime);
+		std::cout << "Bulk vs scalar (" << Label << "): targets " << targetError << ", deltaTime " << clockError << std::endl;
+		return targetError <= 1e-4 && clockError <= 1e-9;
+	}
+
+	// Gait tables on for Foot_IK, through EvaluateBinding and the bulk path, against the exact
+	// formulas. Inputs other than velocity and t_cycle are held at the first frame, so the
+	// tables' guards (bone lengths) hold and the rows are actually read from the tables.
+	bool CheckGaitTables(const NRModelProfile& Profile, const torch::Tensor& Frames)
+	{
+		const int64_t outCount = Profile.GetRequiredOutputSize();
+		const NRGaitTableOptions options;
+
+		auto frames = Frames.slice(0, 0, 1).expand_as(Frames).clone();
+		for (const auto& block : Profile.Inputs)
+		{
+			if (block.Name == "velocity" || block.Name == "t_cycle")
+			{
+				frames.narrow(1, block.Offset, block.FloatCount).copy_(Frames.narrow(1, block.Offset, block.FloatCount));
+			}
+		}
+		frames = frames.contiguous();
+
+		const Rules base = SetupRules(Profile);
+
+		Rules exact = base;
+		const auto expected = EvaluateScalar(exact, Profile, frames, outCount);
+		Rules scalar = base;
+		scalar.EnableGaitTables(options);
+		const auto tabulated = EvaluateScalar(scalar, Profile, frames, outCount);
+
+		Rules bulkExact = base;
+		BulkEvaluator exactEvaluator(bulkExact, Profile);
+		auto bulkExpected = torch::zeros({frames.size(0), outCount});
+		exactEvaluator.Evaluate(frames, bulkExpected.data_ptr<float>(), outCount);
+
+		Rules bulk = base;
+		bulk.EnableGaitTables(options);
+		BulkEvaluator tableEvaluator(bulk, Profile);
+		auto bulkTabulated = torch::zeros({frames.size(0), outCount});
+		tableEvaluator.Evaluate(frames, bulkTabulated.data_ptr<float>(), outCount);
+
+		auto countTables = [](const Rules& Evaluator) {
+			int32_t count = 0;
+			for (const auto& binding : Evaluator.CompiledRules)
+			{
+				for (const auto& compiled : binding)
+				{
+					count += compiled.Tabulated.Table ? 1 : 0;
+				}
+			}
+			return count;
+		};
+
+		const int32_t scalarTables = countTables(scalar);
+		const int32_t bulkTables = countTables(bulk);
+		const double scalarError = (tabulated - expected).abs().max().item<double>();
+		const double bulkError = (bulkTabulated - bulkExpected).abs().max().item<double>();
+		std::cout << "Gait tables: scalar " << scalarTables << " tables, max error " << scalarError
+			<< " | bulk " << bulkTables << " tables, max error " << bulkError << std::endl;
+		return scalarTables > 0 && bulkTables > 0 && scalarError <= options.Tolerance && bulkError <= options.Tolerance;
+	}
+
+	class NRLinearModel : public IModel<float>
+	{
+	public:
+		torch::nn::Linear Layer{nullptr};
+
+		NRLinearModel(int64_t InSize, int64_t OutSize)
+		{
+			Layer = register_module("layer", torch::nn::Linear(InSize, OutSize));
+		}
+
+		torch::Tensor Forward(torch::Tensor Input) override { return Layer->forward(Input); }
+		void SaveModel(const std::string&) override {}
+		void LoadModel(const std::string&) override {}
+	};
+
+	// Every Logic, Condition and Formula of the profile, plus operator cases where a
+	// precedence slip would show, evaluated by TensorExpr and by muParser
+	bool CheckExpressions(const NRModelProfile& Profile, const torch::Tensor& Frames)
+	{
+		Rules evaluator = SetupRules(Profile);
+		const int64_t outCount = Profile.GetRequiredOutputSize();
+		EvaluateScalar(evaluator, Profile, Frames.slice(0, 0, 1).contiguous(), outCount);
+
+		const std::vector<std::string> operators = {
+			"2 == 2 < 3", "3 != 2 > 1", "-velocity^2", "velocity > 1 ? 2 * velocity : -velocity",
+			"velocity > 1 && bone_l2 <= 1 || !(bone_l0 >= 1)",
+		};
+
+		double maxError = 0.0;
+		int32_t checked = 0;
+		for (size_t b = 0; b < evaluator.CompiledRules.size(); ++b)
+		{
+			std::vector<std::string> names;
+			std::vector<torch::Tensor> vars;
+			for (const auto& [name, value] : evaluator.Vars[b])
+			{
+				names.push_back(name);
+				vars.push_back(torch::scalar_tensor(value, torch::kDouble));
+			}
+			const TensorExpr::Resolver resolve = [&names](const std::string& name) {
+				auto it = std::find(names.begin(), names.end(), name);
+				return it != names.end() ? static_cast<int32_t>(it - names.begin()) : -1;
+			};
+
+			std::vector<ExprHandle> handles;
+			for (const auto& compiled : evaluator.CompiledRules[b])
+			{
+				for (const auto& [_slot, handle] : compiled.Logic)
+				{
+					handles.push_back(handle);
+				}
+				for (const auto& phase : compiled.Phases)
+				{
+					handles.push_back(phase.Condition);
+					handles.insert(handles.end(), phase.Formulas.begin(), phase.Formulas.end());
+				}
+			}
+			const auto& defined = evaluator.Vars[b];
+			if (defined.contains("velocity") && defined.contains("bone_l0") && defined.contains("bone_l2"))
+			{
+				for (const auto& expression : operators)
+				{
+					handles.push_back(evaluator.Compile(static_cast<int>(b), expression));
+				}
+			}
+
+			for (const auto handle : handles)
+			{
+				const std::string& source = evaluator.GetSource(handle);
+				TensorExpr expr;
+				if (!expr.Compile(source, resolve))
+				{
+					std::cerr << "TensorExpr rejected [" << source << "]: " << expr.GetError() << std::endl;
+					return false;
+				}
+
+				const double expected = evaluator.Eval(handle);
+				const double actual = expr.Eval(vars, torch::TensorOptions().dtype(torch::kDouble)).item<double>();
+				const double error = std::abs(actual - expected);
+				if (error > 1e-9)
+				{
+					std::cerr << "Mismatch [" << source << "]: muParser " << expected << ", tensor " << actual << std::endl;
+				}
+				maxError = std::max(maxError, error);
+				++checked;
+			}
+		}
+
+		std::cout << "TensorExpr vs muParser: " << checked << " expressions, max error " << maxError << std::endl;
+		return checked > 0 && maxError <= 1e-9;
+	}
+
+	bool CheckTensorTargets(const NRModelProfile& Profile, const torch::Tensor& Frames)
+	{
+		const int64_t inCount = Profile.GetRequiredInputSize();
+		const int64_t outCount = Profile.GetRequiredOutputSize();
+
+		Rules base;
+		Trainee<float> muParser(std::make_shared<NRLinearModel>(inCount, outCount), nullptr, Profile, base);
+		Trainee<float> tensor(std::make_shared<NRLinearModel>(inCount, outCount), nullptr, Profile, base);
+		muParser.UseTensorTargets(false);
+		if (!tensor.UseTensorTargets(true))
+		{
+			std::cerr << "Foot_IK rules could not be lowered to tensors" << std::endl;
+			return false;
+		}
+
+		// Two batches, so the gait clock carried from the first one is compared as well
+		double maxError = 0.0;
+		for (const auto& batch : Frames.chunk(2))
+		{
+			const auto expected = muParser.ComputeTargets(batch);
+			const auto actual = tensor.ComputeTargets(batch);
+			if (actual.scalar_type() != expected.scalar_type() || actual.sizes() != expected.sizes())
+			{
+				std::cerr << "TensorRules targets differ in dtype or shape from ComputeTargets" << std::endl;
+				return false;
+			}
+			maxError = std::max(maxError, (actual - expected).abs().max().item<double>());
+		}
+
+		std::cout << "TensorRules vs muParser ComputeTargets: max error " << maxError << std::endl;
+		return maxError <= 1e-4;
+	}
+} // namespace
+
+int main()
+{
+	std::string DataAssetPath_IK = "Tests/Datasets/Foot_IK.json";
+	std::string DataAssetPath_SK = "Tests/Datasets/Foot_SK.json";
+	std::string DataAssetPath_TW = "Tests/Datasets/Foot_TW.json";
+	if (!std::filesystem::exists(DataAssetPath_IK))
+	{
+		DataAssetPath_IK = "../Tests/Datasets/Foot_IK.json";
+		DataAssetPath_SK = "../Tests/Datasets/Foot_SK.json";
+		DataAssetPath_TW = "../Tests/Datasets/Foot_TW.json";
+	}
+
+	DefaultQuat Quat;
+	NRModelProfile Profile;
+	if (!Parse::LoadIKFromJson(DataAssetPath_IK, Profile)
+	    || !Parse::LoadSKFromJson(DataAssetPath_SK, Profile.Skeleton, &Quat)
+	    || !Parse::LoadTWFromJson(DataAssetPath_TW, Profile.TrainingWeights))
+	{
+		std::cerr << "Failed to load profile assets: " << DataAssetPath_IK << ", " << DataAssetPath_SK << ", " << DataAssetPath_TW << std::endl;
+		return 1;
+	}
+
+	// Positive inputs keep sqrt(velocity / f_offset) and the gait period defined
+	torch::manual_seed(11);
+	const int64_t Batch = 32;
+	const auto Frames = (torch::rand({Batch, Profile.GetRequiredInputSize()}) + 0.5f).contiguous();
+
+	NRModelProfile Reversed = Profile;
+	for (auto& binding : Reversed.Bindings)
+	{
+		for (auto& rule : binding.Rules)
+		{
+			std::reverse(rule.Logic.begin(), rule.Logic.end());
+		}
+	}
+
+	bool bPassed = CheckBulk("declared", Profile, Frames);
+	bPassed &= CheckBulk("reversed Logic", Reversed, Frames);
+	bPassed &= CheckGaitTables(Profile, Frames);
+	bPassed &= CheckExpressions(Profile, Frames);
+	bPassed &= CheckTensorTargets(Profile, Frames);
+	if (!bPassed)
+	{
+		std::cerr << "Rules validation failed!" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Validation completed!" << std::endl;
+	return 0;
+}
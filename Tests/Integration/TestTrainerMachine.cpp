@@ -17,7 +17,9 @@
 #include "Core/Parse.h"
 #include "Network/NetworkServer.h"
 #include "Network/NetworkClient.h"
-#include "Solver/Solver.h"
+#include "Solver/ProfileRegistry.h"
+#include "Trainee/ProfileReloader.h"
+#include "Trainee/TargetPipeline.h"
 #include "Trainee/Trainee.h"
 #include <iostream>
 #include <string>
@@ -73,6 +75,12 @@ public:
 
 		return torch::stack({pitch, yaw, roll}, -1);
 	}
+
+	// ToEuler already works on [N, 4], so the whole skeleton is converted in one call
+	NR::Vec3 ToEulerBatch(const NR::Quat& q) const override
+	{
+		return ToEuler(q);
+	}
 };
 
 class NRMultiHeadModel : public NR::IModel<float>
@@ -140,7 +148,7 @@ int main()
 
 	NRModelProfile ActiveProfile;
 	Rules ActiveRules;
-	std::shared_ptr<Solver> NRSolver = nullptr;
+	int32_t SolverProfile = -1; // Handle in the registry once solving started
 	std::shared_ptr<IQuat> CustomQuat = nullptr;
 
 	//std::string DataAssetPath_IK = "Tests/Datasets/Foot_IK.json";
@@ -160,26 +168,16 @@ int main()
 	DataAssetPath_SK = std::filesystem::absolute(DataAssetPath_SK).string();
 	DataAssetPath_TW = std::filesystem::absolute(DataAssetPath_TW).string();
 
-	if (!Parse::LoadIKFromJson(DataAssetPath_IK, ActiveProfile))
-	{
-		std::cerr << "Failed to load IK asset: " << DataAssetPath_IK << std::endl;
-		return 1;
-	}
-
 	if (!CustomQuat)
 	{
 		CustomQuat = std::make_shared<TestQuatFromUnreal>();
 	}
 
-	if (!Parse::LoadSKFromJson(DataAssetPath_SK, ActiveProfile.Skeleton, CustomQuat.get()))
-	{
-		std::cerr << "Failed to load SK asset: " << DataAssetPath_SK << std::endl;
-		return 1;
-	}
-
-	if (!Parse::LoadTWFromJson(DataAssetPath_TW, ActiveProfile.TrainingWeights))
+	// JSON is only parsed again when one of the three files changes
+	const std::string ProfileCachePath = DataAssetPath_IK + ".nrpc";
+	if (!Parse::LoadProfileCached(DataAssetPath_IK, DataAssetPath_SK, DataAssetPath_TW, ProfileCachePath, ActiveProfile, CustomQuat.get()))
 	{
-		std::cerr << "Failed to load TW asset: " << DataAssetPath_TW << std::endl;
+		std::cerr << "Failed to load profile assets: " << DataAssetPath_IK << ", " << DataAssetPath_SK << ", " << DataAssetPath_TW << std::endl;
 		return 1;
 	}
 
@@ -193,7 +191,11 @@ int main()
 	auto Model = std::make_shared<NRMultiHeadModel>(InputSize, 512, OutSize);
 	std::cout << "Model created!" << std::endl;
 
+	// A single rig type here, so every profile shares the model being trained
+	ProfileRegistry Registry([&](const NRModelProfile&) { return std::static_pointer_cast<IModel<float> >(Model); });
+
 	auto NRTrainee = std::make_shared<Trainee<float> >(Model, CustomQuat.get(), ActiveProfile, ActiveRules, 4e-3);
+	NRTrainee->Diag.Enable(30);
 	std::cout << "Model trainee configuration!" << std::endl;
 
 	std::string ModelSavePath = "Datasets/trained_model.pt";
@@ -209,7 +211,7 @@ int main()
 	{
 		try
 		{
-			Model->LoadModel(ModelSavePath);
+			NRTrainee->LoadWeights(ModelSavePath);
 			std::cout << ">>> Modelo carregado com sucesso de: " << ModelSavePath << std::endl;
 		}
 		catch (const std::exception& e)
@@ -229,71 +231,97 @@ int main()
 		std::cout << "----------------------------------" << std::endl;
 		std::cout << "Waiting for messages..." << std::endl;
 		static int frameCounter = 0;
+
+		// Os alvos ideais do próximo frame são calculados enquanto o passo atual treina
+		TargetPipeline<float> Pipeline(*NRTrainee, 4);
+
+		// Edits to the IK/SK/TW files are picked up without restarting the server
+		ProfileReloader Reloader(DataAssetPath_IK, DataAssetPath_SK, DataAssetPath_TW, CustomQuat.get(), ProfileCachePath, ActiveRules);
+		Reloader.Start();
+
 		while (true)
 		{
+			if (auto compiled = Reloader.TakePending())
+			{
+				auto trainerLock = Pipeline.LockTrainer();
+				if (NRTrainee->Reload(std::move(*compiled)))
+				{
+					ActiveProfile = NRTrainee->GetProfile();
+					if (SolverProfile >= 0)
+					{
+						Registry.Register(ActiveProfile.ProfileName, ActiveProfile);
+					}
+					std::cout << "[HotReload] Profile swapped: " << ActiveProfile.ProfileName << std::endl;
+				}
+			}
+
 			std::vector<float> data;
-			if (Server.Receive(data))
+			bool bReceived = Server.Receive(data) && !data.empty();
+			if (bReceived)
 			{
-				if (data.empty())
+				const int32_t requiredSize = InputSize; // Hot reloads keep the input layout
+				if (data.size() < static_cast<size_t>(requiredSize))
 				{
-					continue;
+					std::cerr << "[Server] Incomplete data received: " << data.size() << " floats, expected at least " << requiredSize << std::endl;
+					bReceived = false;
 				}
+				else
+				{
+					Pipeline.TrySubmit(data);
+				}
+			}
 
-				if (NRTrainee)
+			if (auto loss = Pipeline.TryStep())
+			{
+				if (frameCounter++ % 30 == 0)
 				{
-					int32_t requiredSize = ActiveProfile.GetRequiredInputSize();
-					if (data.size() < static_cast<size_t>(requiredSize))
-					{
-						std::cerr << "[Server] Incomplete data received: " << data.size() << " floats, expected at least " << requiredSize << std::endl;
-						continue;
-					}
+					auto stats = Pipeline.Stats();
+					std::cout << "----------------------------------" << std::endl;
+					std::cout << " Loss: " << *loss << std::endl;
+					std::cout << " frame counter:" << frameCounter << std::endl;
+					std::cout << " targets: " << stats.TargetMs << " ms | step: " << stats.StepMs << " ms | queue: " << stats.QueueMs << " ms | dropped: " << stats.Dropped << std::endl;
+					std::cout << "----------------------------------" << std::endl;
+				}
 
-					float loss = NRTrainee->TrainStep(data);
-					if (frameCounter++ % 30 == 0)
+				// 2. Salvamento Periódico
+				if (frameCounter % 500 == 0)
+				{
+					try
 					{
-						std::cout << "----------------------------------" << std::endl;
-						std::cout << " Loss: " << loss << std::endl;
-						std::cout << " frame counter:" << frameCounter << std::endl;
-						std::cout << "----------------------------------" << std::endl;
+						NRTrainee->SaveCheckpointAsync(ModelSavePath);
+						std::cout << "[Checkpoint] Snapshot agendado para: " << ModelSavePath << " (Frame: " << frameCounter << ")" << std::endl;
 					}
-
-					// 2. Salvamento Periódico
-					if (frameCounter % 500 == 0)
+					catch (const std::exception& e)
 					{
-						try
-						{
-							Model->SaveModel(ModelSavePath);
-							std::cout << "[Checkpoint] Modelo salvo automaticamente em: " << ModelSavePath << " (Frame: " << frameCounter << ")" << std::endl;
-						}
-						catch (const std::exception& e)
-						{
-							std::cerr << "[Erro] Falha ao salvar checkpoint: " << e.what() << std::endl;
-						}
+						std::cerr << "[Erro] Falha ao salvar checkpoint: " << e.what() << std::endl;
 					}
+				}
 
-					if (NRTrainee->IdealTargets.defined())
-					{
-						const float* dDataPtr = NRTrainee->IdealTargets.data_ptr<float>();
-						auto dNumElements = NRTrainee->IdealTargets.numel();
-						std::vector<float> debugData(dDataPtr, dDataPtr + dNumElements);
+				if (NRTrainee->IdealTargets.defined())
+				{
+					const float* dDataPtr = NRTrainee->IdealTargets.data_ptr<float>();
+					auto dNumElements = NRTrainee->IdealTargets.numel();
+					std::vector<float> debugData(dDataPtr, dDataPtr + dNumElements);
 
-						ClientDebug.Send(debugData, "127.0.0.1", 8007);
-					}
+					ClientDebug.Send(debugData, "127.0.0.1", 8007);
+				}
+			}
 
-					if (!NRSolver)
-					{
-						NRSolver = std::make_shared<Solver>(Model, ActiveProfile);
-						std::cout << "=== SWITCHING TO SOLVER MODE ===" << std::endl;
-					}
+			if (bReceived)
+			{
+				if (SolverProfile < 0)
+				{
+					SolverProfile = Registry.Register(ActiveProfile.ProfileName, ActiveProfile);
+					std::cout << "=== SWITCHING TO SOLVER MODE ===" << std::endl;
+				}
 
-					if (NRSolver)
-					{
-						std::vector<float> solveInput(InputSize);
-						std::memcpy(solveInput.data(), data.data(), InputSize * sizeof(float));
+				if (SolverProfile >= 0)
+				{
+					std::vector<float> solveInput(InputSize);
+					std::memcpy(solveInput.data(), data.data(), InputSize * sizeof(float));
 
-						std::vector<float> predicted = NRSolver->Solve(solveInput);
-						ClientSolver.Send(predicted, "127.0.0.1", 8006);
-					}
+					std::vector<float> predicted = Registry.Solve(SolverProfile, solveInput);
+					ClientSolver.Send(predicted, "127.0.0.1", 8006);
 				}
 			}
 		}